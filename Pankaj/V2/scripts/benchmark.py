@@ -7,31 +7,49 @@ with various configurations, supporting strong and weak scaling analysis.
 """
 
 import csv
+import itertools
 import json
 import multiprocessing
 import os
 import re
 import shutil
+import struct
 import subprocess
 import sys
 import time
 from collections import defaultdict
 from datetime import datetime
+from math import comb
 import numpy as np
 import pandas as pd
 from pathlib import Path
 
 # ===================== CONFIGURATION =====================
 # Implementations to benchmark
+# Values are either a binary path or (binary path, [extra options]), e.g.
+#   "ind_IO_der_tm": ("../src/bin/independentIO_derData", ["--layout=time"])
 IMPLEMENTATIONS = {
     "send": "../src/bin/pankaj_code7",
     # "mem_send": "../src/bin/pankaj_code9",
     # "bsend": "../src/bin/pankaj_code10",
     "isend": "../src/bin/pankaj_code11",
+    # "alltoallw": "../src/bin/alltoallw",
     # "ind_IO": "../src/bin/independentIO",
     # "coll_IO": "../src/bin/collectiveIO",
     # "ind_IO_der": "../src/bin/independentIO_derData",
     # "coll_IO_der": "../src/bin/collectiveIO_derData",
+    # Hybrid MPI+OpenMP build, run with every entry of THREAD_COUNTS
+    # "hybrid_isend": "../src/bin/independentIO_derData_and_isend_omp",
+    # Run-time I/O selector; its results can be fed back with --io-calibration=<benchmark_results.csv>
+    # "auto_IO": "../src/bin/independentIO_derData_and_isend",
+    # "level3": ("../src/bin/independentIO_derData_and_isend", ["--io-strategy=level3"]),
+    # Single-node page-cache reader (mmap; read time excludes the page faults)
+    # "mmap_IO": "../src/bin/mmapIO",
+    # Out-of-core z-slab walk for blocks larger than memory (slab buffer per rank)
+    # "ooc_IO": ("../src/bin/outOfCoreIO", ["--memory-limit=256M"]),
+    # Extrema sweep on an accelerator: a CUDA/HIP build (make GPU=cuda) or OpenMP target offload
+    # "gpu_isend": ("../src/bin/independentIO_derData_and_isend", ["--device=gpu"]),
+    # "offload_isend": ("../src/bin/independentIO_derData_and_isend_omp", ["--device=offload"]),
 }
 
 # Datasets
@@ -44,6 +62,11 @@ DATASETS = [
 # Process counts to test
 PROCESS_COUNTS = [8]
 
+# OpenMP threads per rank, applied to implementations whose binary ends in "_omp".
+# Each (processes, threads) pair is one launch: processes ranks on the pX pY pZ grid,
+# OMP_NUM_THREADS=threads and --threads=threads on every rank.
+THREAD_COUNTS = [1]
+
 # Number of iterations per configuration
 ITERATIONS = 5
 
@@ -63,11 +86,98 @@ PROCESS_DECOMPOSITIONS = {
     64: [(4, 4, 4)]
 }
 
+# MPI-IO hint sweep (benchmark.py --sweep-hints): every combination below is run with
+# HINT_SWEEP_IMPLEMENTATION for each dataset and process count, and the set with the lowest
+# mean read time is saved as best_hints_<dataset>_<processes>p.txt for --io-hints=FILE.
+# aggregators_per_node and buffer_stripes are expanded by the binary (see src/common/hints.h);
+# any other key is passed to MPI as is.
+HINT_SWEEP_IMPLEMENTATION = "../src/bin/collectiveIO_derData"
+HINT_SWEEP = {
+    "aggregators_per_node": [1, 2, 4],
+    "striping_unit": [1048576, 4194304],
+    "buffer_stripes": [1, 4],
+    "romio_ds_read": ["enable", "disable"],
+}
+
+# Scaling studies (benchmark.py --scaling=strong|weak [--baseline=FILE] [--save-baseline=FILE])
+# strong: every dataset in DATASETS at each entry of SCALING_PROCESS_COUNTS
+# weak: per count, a volume of WEAK_BLOCK points per rank laid out on the pX pY pZ grid,
+#       written by WEAK_GENERATOR into WEAK_DATA_DIR unless it is already there
+#       (the MPI generator in src/tools; [sys.executable, "generate_data.py"] also works)
+SCALING_PROCESS_COUNTS = [1, 2, 4, 8]
+WEAK_BLOCK = (32, 32, 32)
+WEAK_TIMESTEPS = 7
+WEAK_DATA_DIR = "../data/weak"
+WEAK_GENERATOR = ["mpirun", "-np", str(multiprocessing.cpu_count()), "--oversubscribe",
+                  "../src/bin/generate_data"]
+
+# Statistics: WARMUP_ITERATIONS untimed launches before each configuration, then runs more
+# than OUTLIER_MADS scaled median absolute deviations from the median total time are dropped.
+# Intervals are distribution-free CONFIDENCE intervals of the median.
+WARMUP_ITERATIONS = 1
+OUTLIER_MADS = 3.0
+CONFIDENCE = 0.95
+
+# A configuration regresses when its median total time lies above the baseline's interval
+# and is more than REGRESSION_TOLERANCE slower than the baseline median
+REGRESSION_TOLERANCE = 0.05
+
+# Launcher. RANKS_PER_NODE = 0 runs every rank on the local node; otherwise the ranks are
+# spread over ceil(processes / RANKS_PER_NODE) nodes of the current allocation, through
+# "mpirun" (--npernode) or "srun" (-N, -n)
+LAUNCHER = "mpirun"
+RANKS_PER_NODE = 0
+
+# Rank binding. "none" keeps the launcher's defaults (Open MPI binds to core up to two
+# ranks and round robin by socket beyond, so x-neighbours land on different sockets),
+# "core" packs consecutive ranks onto the cores of a socket before the next one (hybrid
+# launches reserve --threads cores per rank), "socket" does the same but lets each rank
+# float over its socket. GRID_PLACEMENT = "socket" passes --placement=socket so the
+# process grid follows the sockets; BIND_REPORT = True passes --bind-report=1 and keeps
+# each run's binding table in the .log next to its output.
+BINDING = "none"
+GRID_PLACEMENT = "rank"
+BIND_REPORT = False
+
 # Generate visualizations after benchmarking
 GENERATE_VISUALIZATIONS = True
 
 # ===================== END CONFIGURATION =====================
 
+def outlier_mask(values, mads=OUTLIER_MADS):
+    """True for the values kept: within mads scaled MADs of the median (all if the MAD is 0)."""
+    values = np.asarray(values, dtype=float)
+    median = np.median(values)
+    mad = 1.4826 * np.median(np.abs(values - median))
+    if mad == 0:
+        return [True] * len(values)
+    return [bool(abs(v - median) <= mads * mad) for v in values]
+
+def median_interval(values, confidence=CONFIDENCE):
+    """Distribution-free confidence interval of the median from order statistics.
+
+    With B ~ Binomial(n, 1/2) and k the largest rank with P(B < k) <= (1 - confidence) / 2,
+    the interval is [x_(k), x_(n-k+1)]. Below 6 runs no such k exists at 95 % and the
+    full range is returned."""
+    x = sorted(values)
+    n = len(x)
+    k = 0
+    cumulative = 0.0
+    for j in range(n):
+        cumulative += comb(n, j) / 2 ** n
+        if cumulative > (1 - confidence) / 2:
+            break
+        k = j + 1
+    if k == 0:
+        return x[0], x[-1]
+    return x[k - 1], x[n - k]
+
+def karp_flatt(speedup, processes):
+    """Experimentally determined serial fraction (NaN at one process)."""
+    if processes <= 1 or speedup <= 0:
+        return float("nan")
+    return (1 / speedup - 1 / processes) / (1 - 1 / processes)
+
 class BenchmarkRunner:
     """Manages execution and data collection for benchmarking MPI programs."""
 
@@ -79,6 +189,7 @@ class BenchmarkRunner:
         self.iterations = ITERATIONS
         self.timeout = TIMEOUT
         self.process_decompositions = PROCESS_DECOMPOSITIONS
+        self.thread_counts = THREAD_COUNTS
 
         self.results = defaultdict(list)
         self.timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
@@ -110,14 +221,34 @@ class BenchmarkRunner:
             "process_counts": self.process_counts,
             "iterations": self.iterations,
             "process_decompositions": self.process_decompositions,
-            "timeout": self.timeout
+            "thread_counts": self.thread_counts,
+            "timeout": self.timeout,
+            "scaling_process_counts": SCALING_PROCESS_COUNTS,
+            "weak_block": WEAK_BLOCK,
+            "weak_timesteps": WEAK_TIMESTEPS,
+            "warmup_iterations": WARMUP_ITERATIONS,
+            "outlier_mads": OUTLIER_MADS,
+            "confidence": CONFIDENCE,
+            "launcher": LAUNCHER,
+            "ranks_per_node": RANKS_PER_NODE,
+            "binding": BINDING,
+            "grid_placement": GRID_PLACEMENT,
+            "bind_report": BIND_REPORT
         }
 
         with open(os.path.join(self.results_dir, "config.json"), 'w') as f:
             json.dump(config, f, indent=2)
 
     def parse_dimensions(self, dataset):
-        """Extract dimensions from dataset filename."""
+        """Extract dimensions from a chunked header, else from the dataset filename."""
+        if os.path.isfile(dataset):
+            with open(dataset, 'rb') as f:
+                head = f.read(48)
+            if len(head) == 48 and head[:8] == b"TSCHUNK1":
+                # ChunkedHeader (src/common/chunked.h): magic, version, dtype, nX, nY, nZ, timeSteps
+                nx, ny, nz, timesteps = struct.unpack("=4i", head[16:32])
+                return {"nx": nx, "ny": ny, "nz": nz, "timesteps": timesteps}
+
         match = re.search(r'data_(\d+)_(\d+)_(\d+)_(\d+)', dataset)
         if not match:
             print(f"Warning: Could not parse dimensions from {dataset}")
@@ -163,8 +294,9 @@ class BenchmarkRunner:
             options.sort(key=lambda x: max(x)/min(x) if min(x) > 0 else float('inf'))
             return options[0]
         else:
-            print(f"Warning: No valid decomposition found for {processes} processes")
-            return None
+            # The binaries split uneven dimensions themselves and pick the grid for 0 0 0
+            print(f"Note: no evenly dividing decomposition for {processes} processes, using automatic grid")
+            return (0, 0, 0)
 
     def extract_timing(self, output_file):
         """Extract timing information from output file."""
@@ -174,58 +306,153 @@ class BenchmarkRunner:
                 if len(lines) >= 3:
                     timing_line = lines[-1].strip()
                     read_time, main_time, total_time = map(float, timing_line.split(','))
-                    return {
+                    timing = {
                         "read_time": read_time,
                         "main_time": main_time,
                         "total_time": total_time
                     }
+                    timing.update(self.extract_phases(output_file))
+                    return timing
         except Exception as e:
             print(f"Error extracting timing from {output_file}: {e}")
         return None
 
-    def run_benchmark(self, executable, dataset, processes, decomposition, iteration):
+    def extract_phases(self, output_file):
+        """Per-phase breakdown from <output_file>.profile.json (src/common/profile.h).
+
+        Each region becomes phase_<name>_time (slowest rank), phase_<name>_imbalance
+        (max / mean over ranks) and phase_<name>_gbps columns; {} if there is no profile."""
+        profile_file = output_file + ".profile.json"
+        if not os.path.exists(profile_file):
+            return {}
+        try:
+            with open(profile_file, 'r') as f:
+                regions = json.load(f).get("regions", {})
+        except (OSError, ValueError) as e:
+            print(f"Error reading phase breakdown {profile_file}: {e}")
+            return {}
+
+        phases = {}
+        for name, region in regions.items():
+            phases[f"phase_{name}_time"] = region["max"]
+            phases[f"phase_{name}_imbalance"] = region["imbalance"]
+            phases[f"phase_{name}_gbps"] = region["gbps"]
+        return phases
+
+    def extract_io_strategy(self, stdout):
+        """Strategy reported by binaries with the run-time I/O selector ('' for the others).
+
+        The column lets a benchmark_results.csv be passed back as --io-calibration."""
+        match = re.search(r"^I/O strategy: (\w+)", stdout.decode(errors="replace"), re.MULTILINE)
+        return match.group(1) if match else ""
+
+    def split_implementation(self, implementation):
+        """Return (binary path, extra options) for an IMPLEMENTATIONS entry."""
+        if isinstance(implementation, (tuple, list)):
+            return implementation[0], list(implementation[1])
+        return implementation, []
+
+    def thread_counts_for(self, implementation):
+        """Thread counts to sweep: THREAD_COUNTS for hybrid (_omp) binaries, else [None]."""
+        executable, _ = self.split_implementation(implementation)
+        if os.path.basename(executable).endswith("_omp"):
+            return self.thread_counts
+        return [None]
+
+    def node_count(self, processes):
+        """Nodes a launch of processes ranks occupies."""
+        return -(-processes // RANKS_PER_NODE) if RANKS_PER_NODE > 0 else 1
+
+    def launch_prefix(self, processes, threads):
+        """Launcher command for processes ranks; threads is set for hybrid binaries."""
+        if LAUNCHER == "srun":
+            cmd = ["srun", "-N", str(self.node_count(processes)), "-n", str(processes)]
+            if BINDING != "none":
+                cmd += ["--distribution=block:block", f"--cpu-bind={BINDING}s"]
+                if threads is not None:
+                    cmd += [f"--cpus-per-task={threads}"]
+            elif threads is not None:
+                # srun forwards the environment; only the binding has to be lifted
+                cmd += ["--cpu-bind=none"]
+            return cmd
+
+        cmd = ["mpirun", "-np", str(processes), "--oversubscribe"]
+        if RANKS_PER_NODE > 0:
+            cmd += ["--npernode", str(RANKS_PER_NODE)]
+        if threads is not None:
+            cmd += ["-x", "OMP_NUM_THREADS"]
+        if BINDING == "core":
+            # With threads, each rank gets that many consecutive cores for them
+            mapping = f"slot:PE={threads}" if threads is not None else "core"
+            cmd += ["--map-by", mapping, "--bind-to", "core", "--rank-by", "core"]
+        elif BINDING == "socket":
+            cmd += ["--map-by", "core", "--bind-to", "socket", "--rank-by", "core"]
+        elif threads is not None:
+            # Hybrid binary: let each rank's threads spread instead of pinning them all to
+            # the rank's single core
+            cmd += ["--bind-to", "none"]
+        return cmd
+
+    def placement_options(self):
+        """Binary options selected by GRID_PLACEMENT and BIND_REPORT."""
+        options = []
+        if GRID_PLACEMENT != "rank":
+            options.append(f"--placement={GRID_PLACEMENT}")
+        if BIND_REPORT:
+            options.append("--bind-report=1")
+        return options
+
+    def run_benchmark(self, impl_name, implementation, dataset, processes, decomposition, iteration, threads=None):
         """Run a single benchmark instance."""
         # Parse dataset dimensions
         dims = self.parse_dimensions(dataset)
         if not dims:
             return None
 
+        executable, options = self.split_implementation(implementation)
+
         # Prepare output file
-        impl_name = os.path.basename(executable)
         output_file = os.path.join(
             self.raw_dir,
-            f"{impl_name}_{processes}p_{os.path.basename(dataset)}_{iteration}.txt"
+            f"{impl_name}_{processes}p{threads or 1}t_{os.path.basename(dataset)}_{iteration}.txt"
         )
 
         # Prepare command
         px, py, pz = decomposition
-        cmd = [
-            "mpirun", "-np", str(processes),
-            "--oversubscribe",
+        env = dict(os.environ)
+        if threads is not None:
+            env["OMP_NUM_THREADS"] = str(threads)
+            options = options + [f"--threads={threads}"]
+
+        cmd = self.launch_prefix(processes, threads) + [
             executable,
             dataset,
             str(px), str(py), str(pz),
             str(dims["nx"]), str(dims["ny"]), str(dims["nz"]),
             str(dims["timesteps"]),
             output_file
-        ]
+        ] + options + self.placement_options()
 
         print(f"Running: {' '.join(cmd)}")
 
         try:
             # Run the command with timeout
             start_time = time.time()
-            process = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+            process = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, env=env)
 
             try:
                 stdout, stderr = process.communicate(timeout=self.timeout)
                 elapsed = time.time() - start_time
+                if BIND_REPORT:
+                    with open(output_file + ".log", 'wb') as f:
+                        f.write(stdout)
 
                 # Check if output file was created
                 if os.path.exists(output_file):
                     timing = self.extract_timing(output_file)
                     if timing:
                         timing["wall_time"] = elapsed
+                        timing["io_strategy"] = self.extract_io_strategy(stdout)
                         return timing
                     else:
                         print(f"Error: Could not extract timing from output file")
@@ -233,7 +460,7 @@ class BenchmarkRunner:
                     print(f"Error: Output file not created")
 
                 if stderr:
-                    error_log = os.path.join(self.raw_dir, f"{impl_name}_{processes}p_error_{iteration}.log")
+                    error_log = os.path.join(self.raw_dir, f"{impl_name}_{processes}p{threads or 1}t_error_{iteration}.log")
                     with open(error_log, 'wb') as f:
                         f.write(stderr)
                     print(f"Error log saved to {error_log}")
@@ -247,6 +474,122 @@ class BenchmarkRunner:
 
         return None
 
+    def sweep_hints(self):
+        """Search HINT_SWEEP for each dataset and process count; save the fastest set."""
+        keys = list(HINT_SWEEP.keys())
+        combinations = list(itertools.product(*(HINT_SWEEP[k] for k in keys)))
+        hints_dir = os.path.join(self.results_dir, "hints")
+        os.makedirs(hints_dir, exist_ok=True)
+        sweep_rows = []
+
+        for dataset in self.datasets:
+            if not os.path.exists(dataset):
+                print(f"Warning: Dataset {dataset} not found, skipping")
+                continue
+            dims = self.parse_dimensions(dataset)
+            if not dims:
+                continue
+
+            for processes in self.process_counts:
+                decomposition = self.get_decomposition(processes, dims)
+                best = None
+
+                for index, values in enumerate(combinations):
+                    hints = dict(zip(keys, values))
+                    hints_file = os.path.join(hints_dir, f"hints_{index}.txt")
+                    with open(hints_file, 'w') as f:
+                        for key, value in hints.items():
+                            f.write(f"{key}={value}\n")
+
+                    label = f"hints{index}"
+                    print(f"\n{'='*70}")
+                    print(f"Hint set {index+1}/{len(combinations)} on {dataset}, {processes} processes: {hints}")
+                    print(f"{'='*70}")
+
+                    read_times = []
+                    for i in range(self.iterations):
+                        timing = self.run_benchmark(
+                            label, (HINT_SWEEP_IMPLEMENTATION, [f"--io-hints={hints_file}"]),
+                            dataset, processes, decomposition, i
+                        )
+                        if timing:
+                            read_times.append(timing["read_time"])
+                        time.sleep(1)
+
+                    if not read_times:
+                        continue
+                    mean_read = float(np.mean(read_times))
+                    sweep_rows.append(dict(hints, dataset=dataset, processes=processes,
+                                           read_time_mean=mean_read, read_time_std=float(np.std(read_times))))
+                    print(f"Read Time:  {mean_read:.4f}s (±{np.std(read_times):.4f})")
+                    if best is None or mean_read < best[0]:
+                        best = (mean_read, hints)
+
+                if best:
+                    name = f"best_hints_{os.path.splitext(os.path.basename(dataset))[0]}_{processes}p.txt"
+                    best_path = os.path.join(self.results_dir, name)
+                    with open(best_path, 'w') as f:
+                        f.write(f"# Fastest of {len(combinations)} hint sets, mean read time {best[0]:.4f}s\n")
+                        for key, value in best[1].items():
+                            f.write(f"{key}={value}\n")
+                    print(f"\nBest hints for {dataset} at {processes} processes saved to {best_path}")
+
+        if sweep_rows:
+            csv_path = os.path.join(self.results_dir, "hint_sweep.csv")
+            pd.DataFrame(sweep_rows).to_csv(csv_path, index=False)
+            print(f"Sweep results saved to {csv_path}")
+        else:
+            print("No results collected")
+
+    def run_iterations(self, impl_name, implementation, dataset, processes, decomposition, dims, threads):
+        """WARMUP_ITERATIONS untimed launches, then self.iterations timed ones.
+
+        Returns one row per successful timed run; outliers are flagged, not removed."""
+        for w in range(WARMUP_ITERATIONS):
+            print(f"Warm-up {w+1}/{WARMUP_ITERATIONS}")
+            self.run_benchmark(f"{impl_name}_warmup", implementation, dataset, processes, decomposition, w, threads)
+
+        iteration_results = []
+        for i in range(self.iterations):
+            print(f"Iteration {i+1}/{self.iterations}")
+
+            # Run the benchmark
+            timing = self.run_benchmark(
+                impl_name, implementation, dataset, processes, decomposition, i, threads
+            )
+
+            if timing:
+                # Create a separate dictionary for the additional data
+                additional_data = {
+                    "implementation": impl_name,
+                    "dataset": dataset,
+                    "processes": processes,
+                    "threads": threads or 1,
+                    "nodes": self.node_count(processes),
+                    "px": decomposition[0],
+                    "py": decomposition[1],
+                    "pz": decomposition[2],
+                    "iteration": i,
+                    "nx": dims["nx"],
+                    "ny": dims["ny"],
+                    "nz": dims["nz"],
+                    "timesteps": dims["timesteps"],
+                    "problem_size": dims["nx"] * dims["ny"] * dims["nz"] * dims["timesteps"]
+                }
+
+                # Update the timing dictionary
+                timing.update(additional_data)
+                iteration_results.append(timing)
+
+            # Short delay between iterations
+            time.sleep(1)
+
+        if iteration_results:
+            kept = outlier_mask([r["total_time"] for r in iteration_results])
+            for row, keep in zip(iteration_results, kept):
+                row["outlier"] = not keep
+        return iteration_results
+
     def run_all_benchmarks(self):
         """Run all benchmarks according to configuration."""
         results_data = []
@@ -265,59 +608,31 @@ class BenchmarkRunner:
                 if not decomposition:
                     continue
 
-                for impl_name, executable in self.implementations.items():
-                    print(f"\n{'='*70}")
-                    print(f"Benchmarking {impl_name} with {processes} processes on {dataset}")
-                    print(f"Decomposition: {decomposition[0]}x{decomposition[1]}x{decomposition[2]}")
-                    print(f"{'='*70}")
-
-                    iteration_results = []
-                    for i in range(self.iterations):
-                        print(f"Iteration {i+1}/{self.iterations}")
+                for impl_name, implementation in self.implementations.items():
+                    for threads in self.thread_counts_for(implementation):
+                        print(f"\n{'='*70}")
+                        label = f"{processes} processes" if threads is None else f"{processes} ranks x {threads} threads"
+                        print(f"Benchmarking {impl_name} with {label} on {dataset}")
+                        print(f"Decomposition: {decomposition[0]}x{decomposition[1]}x{decomposition[2]}")
+                        print(f"{'='*70}")
 
-                        # Run the benchmark
-                        timing = self.run_benchmark(
-                            executable, dataset, processes, decomposition, i
+                        iteration_results = self.run_iterations(
+                            impl_name, implementation, dataset, processes, decomposition, dims, threads
                         )
+                        results_data.extend(iteration_results)
 
-                        if timing:
-                            # Create a separate dictionary for the additional data
-                            additional_data = {
-                                "implementation": impl_name,
-                                "dataset": dataset,
-                                "processes": processes,
-                                "px": decomposition[0],
-                                "py": decomposition[1],
-                                "pz": decomposition[2],
-                                "iteration": i,
-                                "nx": dims["nx"],
-                                "ny": dims["ny"],
-                                "nz": dims["nz"],
-                                "timesteps": dims["timesteps"],
-                                "problem_size": dims["nx"] * dims["ny"] * dims["nz"] * dims["timesteps"]
-                            }
-
-                            # Update the timing dictionary
-                            timing.update(additional_data)
-
-                            results_data.append(timing)
-                            iteration_results.append(timing)
-
-                        # Short delay between iterations
-                        time.sleep(1)
-
-                    # Compute statistics for this configuration
-                    if iteration_results:
-                        read_times = [r["read_time"] for r in iteration_results]
-                        main_times = [r["main_time"] for r in iteration_results]
-                        total_times = [r["total_time"] for r in iteration_results]
+                        # Compute statistics for this configuration
+                        if iteration_results:
+                            read_times = [r["read_time"] for r in iteration_results]
+                            main_times = [r["main_time"] for r in iteration_results]
+                            total_times = [r["total_time"] for r in iteration_results]
 
-                        print("\nResults:")
-                        print(f"Read Time:  {np.mean(read_times):.4f}s (±{np.std(read_times):.4f})")
-                        print(f"Main Time:  {np.mean(main_times):.4f}s (±{np.std(main_times):.4f})")
-                        print(f"Total Time: {np.mean(total_times):.4f}s (±{np.std(total_times):.4f})")
-                    else:
-                        print("No valid results collected")
+                            print("\nResults:")
+                            print(f"Read Time:  {np.mean(read_times):.4f}s (±{np.std(read_times):.4f})")
+                            print(f"Main Time:  {np.mean(main_times):.4f}s (±{np.std(main_times):.4f})")
+                            print(f"Total Time: {np.mean(total_times):.4f}s (±{np.std(total_times):.4f})")
+                        else:
+                            print("No valid results collected")
 
         # Save complete results to CSV
         if results_data:
@@ -328,7 +643,7 @@ class BenchmarkRunner:
 
             # Also save a summary with statistics
             summary = results_df.groupby(
-                ['implementation', 'dataset', 'processes', 'px', 'py', 'pz']
+                ['implementation', 'dataset', 'processes', 'threads', 'px', 'py', 'pz']
             ).agg({
                 'read_time': ['mean', 'std', 'min', 'max'],
                 'main_time': ['mean', 'std', 'min', 'max'],
@@ -344,24 +659,185 @@ class BenchmarkRunner:
             print("No results collected")
             return None
 
+    def weak_dataset(self, processes):
+        """Dataset, dims and grid of the weak-scaling volume for processes ranks (generated if missing)."""
+        # Every dimension divides evenly, so the configured or most balanced grid is taken
+        grid = self.get_decomposition(processes, {"nx": processes, "ny": processes, "nz": processes})
+        nx, ny, nz = (g * b for g, b in zip(grid, WEAK_BLOCK))
+        dataset = os.path.join(WEAK_DATA_DIR, f"data_{nx}_{ny}_{nz}_{WEAK_TIMESTEPS}.bin")
+
+        if not os.path.exists(dataset):
+            os.makedirs(WEAK_DATA_DIR, exist_ok=True)
+            cmd = WEAK_GENERATOR + [str(nx), str(ny), str(nz), str(WEAK_TIMESTEPS), dataset]
+            print(f"Generating: {' '.join(cmd)}")
+            if subprocess.run(cmd).returncode != 0 or not os.path.exists(dataset):
+                print(f"Error: could not generate {dataset}")
+                return None
+        return dataset, self.parse_dimensions(dataset), grid
+
+    def scaling_plan(self, study):
+        """(dataset, processes, dims, decomposition) for every launch configuration of the study."""
+        plan = []
+        for processes in SCALING_PROCESS_COUNTS:
+            if study == "weak":
+                generated = self.weak_dataset(processes)
+                if generated:
+                    dataset, dims, grid = generated
+                    plan.append((dataset, processes, dims, grid))
+                continue
+            for dataset in self.datasets:
+                if not os.path.exists(dataset):
+                    print(f"Warning: Dataset {dataset} not found, skipping")
+                    continue
+                dims = self.parse_dimensions(dataset)
+                if dims:
+                    plan.append((dataset, processes, dims, self.get_decomposition(processes, dims)))
+        return plan
+
+    def summarize_scaling(self, study, results_df):
+        """Median, interval, speedup, efficiency and Karp-Flatt fraction per configuration.
+
+        strong: speedup = p0 * T(p0) / T(p), efficiency = speedup / p
+        weak:   efficiency = T(p0) / T(p), scaled speedup = p * efficiency
+        with p0 the smallest process count of the series; outliers are left out."""
+        keys = ["implementation", "dataset", "processes", "threads", "nodes", "px", "py", "pz"]
+        outliers = results_df.groupby(keys)["outlier"].sum()
+        rows = []
+        for values, group in results_df[~results_df["outlier"]].groupby(keys):
+            row = dict(zip(keys, values), study=study, runs=len(group), outliers=int(outliers.loc[values]))
+            for metric in ["read_time", "main_time", "total_time"]:
+                low, high = median_interval(group[metric].tolist())
+                row[f"{metric}_median"] = float(np.median(group[metric]))
+                row[f"{metric}_ci_low"] = low
+                row[f"{metric}_ci_high"] = high
+            rows.append(row)
+        summary = pd.DataFrame(rows)
+        if summary.empty:
+            return summary
+
+        # A weak series spans one generated dataset per process count
+        series = ["implementation", "threads"] + (["dataset"] if study == "strong" else [])
+        for _, group in summary.groupby(series):
+            group = group.sort_values("processes")
+            base = group.iloc[0]
+            for index, row in group.iterrows():
+                p = row["processes"]
+                if study == "strong":
+                    speedup = base["processes"] * base["total_time_median"] / row["total_time_median"]
+                    efficiency = speedup / p
+                else:
+                    efficiency = base["total_time_median"] / row["total_time_median"]
+                    speedup = p * efficiency
+                summary.loc[index, "speedup"] = speedup
+                summary.loc[index, "efficiency"] = efficiency
+                summary.loc[index, "karp_flatt"] = karp_flatt(speedup, p)
+        return summary
+
+    def compare_baseline(self, summary, baseline_file):
+        """Flag configurations slower than the saved baseline; returns the regressed rows."""
+        baseline = pd.read_csv(baseline_file)
+        keys = ["study", "implementation", "processes", "threads"]
+        # Datasets are compared by name so a baseline survives a moved data directory
+        summary["dataset_name"] = summary["dataset"].map(os.path.basename)
+        baseline["dataset_name"] = baseline["dataset"].map(os.path.basename)
+        keys.append("dataset_name")
+
+        reference = baseline[keys + ["total_time_median", "total_time_ci_high"]].rename(columns={
+            "total_time_median": "baseline_total_median", "total_time_ci_high": "baseline_total_ci_high"})
+        merged = summary.merge(reference, on=keys, how="left")
+        merged["regression"] = (
+            (merged["total_time_median"] > merged["baseline_total_ci_high"]) &
+            (merged["total_time_median"] > merged["baseline_total_median"] * (1 + REGRESSION_TOLERANCE))
+        )
+        return merged.drop(columns=["dataset_name"])
+
+    def run_scaling(self, study, baseline_file=None, save_baseline=None):
+        """Strong or weak scaling study; returns (raw results, summary) or (None, None)."""
+        results_data = []
+        for dataset, processes, dims, decomposition in self.scaling_plan(study):
+            for impl_name, implementation in self.implementations.items():
+                for threads in self.thread_counts_for(implementation):
+                    print(f"\n{'='*70}")
+                    print(f"{study.capitalize()} scaling: {impl_name} with {processes} processes "
+                          f"on {self.node_count(processes)} node(s), {os.path.basename(dataset)}")
+                    print(f"Decomposition: {decomposition[0]}x{decomposition[1]}x{decomposition[2]}")
+                    print(f"{'='*70}")
+                    rows = self.run_iterations(impl_name, implementation, dataset, processes,
+                                               decomposition, dims, threads)
+                    for row in rows:
+                        row["study"] = study
+                    results_data.extend(rows)
+
+        if not results_data:
+            print("No results collected")
+            return None, None
+
+        results_df = pd.DataFrame(results_data)
+        csv_path = os.path.join(self.results_dir, "benchmark_results.csv")
+        results_df.to_csv(csv_path, index=False)
+        print(f"\nResults saved to {csv_path}")
+
+        summary = self.summarize_scaling(study, results_df)
+        if baseline_file:
+            summary = self.compare_baseline(summary, baseline_file)
+
+        print(f"\n{'Implementation':<16} {'Procs':>5} {'Median (s)':>11} {f'{CONFIDENCE:.0%} interval':>20} "
+              f"{'Speedup':>8} {'Eff.':>6} {'Serial':>7}")
+        for _, row in summary.sort_values(["implementation", "processes"]).iterrows():
+            interval = f"[{row['total_time_ci_low']:.4f}, {row['total_time_ci_high']:.4f}]"
+            flag = "  REGRESSION" if row.get("regression", False) else ""
+            print(f"{row['implementation']:<16} {row['processes']:>5} {row['total_time_median']:>11.4f} {interval:>20} "
+                  f"{row['speedup']:>8.2f} {row['efficiency']:>6.2f} {row['karp_flatt']:>7.3f}{flag}")
+
+        summary_path = os.path.join(self.results_dir, "scaling_summary.csv")
+        summary.to_csv(summary_path, index=False)
+        print(f"Scaling summary saved to {summary_path}")
+        if save_baseline:
+            shutil.copyfile(summary_path, save_baseline)
+            print(f"Baseline saved to {save_baseline}")
+
+        return results_df, summary
+
+def option_value(name):
+    """Value of --name=VALUE on the command line, None if absent."""
+    for arg in sys.argv[1:]:
+        if arg.startswith(f"--{name}="):
+            return arg.split("=", 1)[1]
+    return None
+
 def main():
     """Main entry point for the benchmarking script."""
 
     # Run benchmarks
     runner = BenchmarkRunner()
-    results = runner.run_all_benchmarks()
+    if "--sweep-hints" in sys.argv[1:]:
+        runner.sweep_hints()
+        return 0
+    study = option_value("scaling")
+    summary = None
+    if study:
+        if study not in ("strong", "weak"):
+            print(f"Error: --scaling must be strong or weak, not {study}")
+            return 1
+        results, summary = runner.run_scaling(study, option_value("baseline"), option_value("save-baseline"))
+    else:
+        results = runner.run_all_benchmarks()
 
     # Generate visualizations if requested
     if GENERATE_VISUALIZATIONS and results is not None:
         try:
             print("\nGenerating visualizations...")
-            from visualize import generate_visualizations
-            generate_visualizations(runner.results_dir, results)
+            from visualize import generate_all_visualizations
+            generate_all_visualizations(results, os.path.join(runner.results_dir, "figures"), summary)
         except ImportError:
             print("Warning: Could not import visualization module")
         except Exception as e:
             print(f"Error generating visualizations: {e}")
 
+    # A regression against the baseline fails the run, so the driver can gate a CI job
+    if summary is not None and "regression" in summary and summary["regression"].any():
+        print(f"\n{int(summary['regression'].sum())} configuration(s) regressed against the baseline")
+        return 1
     return 0
 
 if __name__ == "__main__":
@@ -4,14 +4,24 @@ Data Generator for Time Series Parallel Processing
 Creates synthetic 3D time series data files for testing parallel implementations.
 
 Usage: python generate_data.py nx ny nz timesteps [output_file] [--pattern {wave|random|blend}]
-
-The output is a binary file containing float32 values, with each grid point's time series
-stored sequentially.
+                               [--dtype {float32|float64}] [--chunked [--brick X,Y,Z] [--align BYTES]]
+
+The output is a binary file containing float32 (or float64) values, with each grid point's
+time series stored sequentially, and a <output_file>.meta side-car declaring the type.
+With --chunked the output is instead a self-describing .tsc file (src/common/chunked.h):
+a header with dims and dtype, a per-brick min/max index and the bricks, packed or aligned to
+--align bytes (the file system stripe). The bricks
+are written uncompressed; raw_to_chunked --compress=zlib converts a .bin into compressed bricks.
+
+For large volumes use the MPI generator instead (same patterns, seeded, every rank
+writing its own slab):
+    mpirun -np N ../src/bin/generate_data nx ny nz timesteps out.bin [--pattern=P] [--dtype=D] [--seed=S]
 """
 
 import numpy as np
 import argparse
 import os
+import struct
 import time
 from math import sin, cos, exp, sqrt
 
@@ -98,8 +108,8 @@ def generate_blend_data(nx, ny, nz, timesteps):
 
     return data
 
-def write_data_file(data, output_file):
-    """Write the generated data to a binary file containing float32 values."""
+def write_data_file(data, output_file, dtype="float32"):
+    """Write the generated data as float32 or float64 values plus a .meta side-car."""
     nx, ny, nz, timesteps = data.shape
     total_points = nx * ny * nz
 
@@ -110,21 +120,84 @@ def write_data_file(data, output_file):
     print(f"Writing binary data to {output_file}...")
     start_time = time.time()
 
-    # Convert data to float32 to save space
-    data_float32 = data.astype(np.float32)
+    # Store in the requested precision (float32 halves the file)
+    data_typed = data.astype(np.float32 if dtype == "float32" else np.float64)
 
     # Reshape to have each grid point's time series as a row
     # This reshapes from (nx, ny, nz, timesteps) to (nx*ny*nz, timesteps)
-    reshaped_data = data_float32.reshape(nx * ny * nz, timesteps)
+    reshaped_data = data_typed.reshape(nx * ny * nz, timesteps)
 
     # Write to binary file
     with open(output_file, 'wb') as f:
         reshaped_data.tofile(f)
 
+    # Side-car read by the native-precision implementations (src/common/dataset.h)
+    with open(output_file + ".meta", 'w') as f:
+        f.write(f"dtype={dtype}\nnx={nx}\nny={ny}\nnz={nz}\ntimesteps={timesteps}\n")
+
     file_size_mb = os.path.getsize(output_file) / (1024 * 1024)
     print(f"Binary file written successfully in {time.time() - start_time:.2f} seconds")
     print(f"Output file size: {file_size_mb:.2f} MB")
 
+# Layout of ChunkedHeader in src/common/chunked.h (native byte order, 80 bytes)
+CHUNKED_HEADER = struct.Struct("=8s10i4q")
+CHUNKED_MAGIC = b"TSCHUNK1"
+
+def round_up(value, alignment):
+    return -(-value // alignment) * alignment if alignment > 0 else value
+
+def write_chunked_file(data, output_file, dtype="float32", brick=None, alignment=0):
+    """Write the generated data in the chunked format with a per-brick min/max index."""
+    nx, ny, nz, timesteps = data.shape
+    if not output_file.endswith('.tsc'):
+        output_file = os.path.splitext(output_file)[0] + '.tsc'
+
+    print(f"Writing chunked data to {output_file}...")
+    start_time = time.time()
+
+    # Same bytes as the raw file, viewed the way the readers index it: [z][y][x][t], x fastest
+    typed = data.astype(np.float32 if dtype == "float32" else np.float64)
+    grid = typed.reshape(nz, ny, nx, timesteps)
+    item = typed.itemsize
+
+    if brick is None:
+        edge = max(1, int(round(((alignment or 1048576) / (timesteps * item)) ** (1 / 3))))
+        while edge > 1 and edge ** 3 * timesteps * item > (alignment or 1048576):
+            edge -= 1
+        # Even the edge out over each axis so the last brick is not mostly padding
+        brick = tuple(-(-n // -(-n // edge)) for n in (nx, ny, nz))
+    bx, by, bz = brick
+    counts = (-(-nx // bx), -(-ny // by), -(-nz // bz))
+    bricks = counts[0] * counts[1] * counts[2]
+
+    index_offset = CHUNKED_HEADER.size
+    data_offset = round_up(index_offset + bricks * timesteps * 2 * 8, alignment)
+    stride = round_up(bx * by * bz * timesteps * item, alignment)
+
+    index = np.empty((bricks, timesteps, 2), dtype=np.float64)
+    with open(output_file, 'wb') as f:
+        f.write(CHUNKED_HEADER.pack(CHUNKED_MAGIC, 1, 0 if dtype == "float32" else 1,
+                                    nx, ny, nz, timesteps, bx, by, bz, 0,
+                                    alignment, index_offset, data_offset, stride))
+        for k in range(counts[2]):
+            for j in range(counts[1]):
+                for i in range(counts[0]):
+                    b = (k * counts[1] + j) * counts[0] + i
+                    block = grid[k * bz:(k + 1) * bz, j * by:(j + 1) * by, i * bx:(i + 1) * bx, :]
+                    series = block.reshape(-1, timesteps)
+                    index[b, :, 0] = series.min(axis=0)
+                    index[b, :, 1] = series.max(axis=0)
+                    f.seek(data_offset + b * stride)
+                    np.ascontiguousarray(block).tofile(f)
+        f.seek(index_offset)
+        index.tofile(f)
+
+    file_size_mb = os.path.getsize(output_file) / (1024 * 1024)
+    print(f"Chunked file written in {time.time() - start_time:.2f} seconds "
+          f"({bx}x{by}x{bz} bricks, alignment {alignment})")
+    print(f"Output file size: {file_size_mb:.2f} MB")
+    return output_file
+
 def main():
     parser = argparse.ArgumentParser(description='Generate synthetic 3D time series data for parallel processing.')
     parser.add_argument('nx', type=int, help='Number of grid points in X dimension')
@@ -137,6 +210,15 @@ def main():
     parser.add_argument('--pattern', choices=['wave', 'random', 'blend'],
                         default='random',
                         help='Data pattern to generate (default: blend)')
+    parser.add_argument('--dtype', choices=['float32', 'float64'],
+                        default='float32',
+                        help='Element type written to the file and its .meta side-car (default: float32)')
+    parser.add_argument('--chunked', action='store_true',
+                        help='Write the self-describing chunked format (.tsc) instead of raw .bin')
+    parser.add_argument('--brick', type=str, default=None,
+                        help='Chunked brick edge as X,Y,Z points (default: about one alignment unit, or 1 MiB)')
+    parser.add_argument('--align', type=int, default=0,
+                        help='Chunked brick alignment in bytes, e.g. the file system stripe (default: 0, packed)')
 
     args = parser.parse_args()
 
@@ -160,7 +242,11 @@ def main():
         data = generate_blend_data(args.nx, args.ny, args.nz, args.timesteps)
 
     # Write data to file
-    write_data_file(data, args.output_file)
+    if args.chunked:
+        brick = tuple(int(v) for v in args.brick.split(',')) if args.brick else None
+        args.output_file = write_chunked_file(data, args.output_file, args.dtype, brick, args.align)
+    else:
+        write_data_file(data, args.output_file, args.dtype)
 
     print(f"Done! Data file created: {args.output_file}")
     return 0
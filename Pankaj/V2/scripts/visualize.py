@@ -737,13 +737,149 @@ def plot_dataset_comparison_combined(df, processes, output_dir):
     print(f"Saved: {output_file}")
     plt.close()
 
-def generate_all_visualizations(df, output_dir):
+# Phase order of the instrumentation regions (src/common/profile.h)
+PHASES = ["open", "view", "read", "decompress", "pack", "send", "wait", "compute", "reduce", "write"]
+
+def plot_phase_breakdown(df, dataset, processes, output_dir):
+    """
+    Stacked per-phase time (slowest rank) per implementation, with the imbalance ratio
+    of each phase, from the phase_* columns of benchmarks that wrote a profile.
+
+    Args:
+        df (DataFrame): The benchmark results
+        dataset (str): The dataset to analyze
+        processes (int): The process count to analyze
+        output_dir (str): Directory to save the plot
+    """
+    phases = [p for p in PHASES if f"phase_{p}_time" in df.columns]
+    filtered_df = df[(df['dataset'] == dataset) & (df['processes'] == processes)]
+    if not phases or filtered_df.empty:
+        return
+
+    time_columns = [f"phase_{p}_time" for p in phases]
+    imbalance_columns = [f"phase_{p}_imbalance" for p in phases]
+    summary = filtered_df.groupby('implementation')[time_columns + imbalance_columns].mean()
+    summary = summary.dropna(how='all', subset=time_columns).fillna(0)
+    if summary.empty:
+        return
+    summary = summary.loc[sort_implementations(summary.index)]
+
+    fig, (ax_time, ax_imbalance) = plt.subplots(1, 2, figsize=(max(14, len(summary) * 3), 8))
+    br = np.arange(len(summary))
+
+    bottom = np.zeros(len(summary))
+    for i, phase in enumerate(phases):
+        values = summary[f"phase_{phase}_time"].values
+        ax_time.bar(br, values, bottom=bottom, width=0.65, color=COLORS[i % len(COLORS)],
+                    edgecolor='grey', label=phase)
+        bottom += values
+    ax_time.set_xticks(br)
+    ax_time.set_xticklabels(summary.index, fontsize=11)
+    ax_time.set_ylabel('Time at the slowest rank (s)')
+    ax_time.set_title('Phase breakdown')
+    ax_time.legend(loc='upper right', framealpha=0.9)
+    ax_time.yaxis.grid(True, linestyle='--', alpha=0.7)
+
+    width = 0.8 / len(phases)
+    for i, phase in enumerate(phases):
+        ax_imbalance.bar(br + (i - len(phases) / 2) * width + width / 2,
+                         summary[f"phase_{phase}_imbalance"].values, width=width,
+                         color=COLORS[i % len(COLORS)], label=phase)
+    ax_imbalance.axhline(1.0, color='black', linestyle='--', linewidth=1)
+    ax_imbalance.set_xticks(br)
+    ax_imbalance.set_xticklabels(summary.index, fontsize=11)
+    ax_imbalance.set_ylabel('Imbalance (max / mean over ranks)')
+    ax_imbalance.set_title('Load imbalance per phase')
+    ax_imbalance.yaxis.grid(True, linestyle='--', alpha=0.7)
+
+    fig.suptitle(f"{os.path.basename(dataset)}, {processes} processes", fontsize=14)
+    plt.tight_layout(pad=2.0)
+
+    os.makedirs(output_dir, exist_ok=True)
+    output_file = os.path.join(output_dir, f"phase_breakdown_{os.path.basename(dataset)}_{processes}p.png")
+    plt.savefig(output_file, dpi=300)
+    print(f"Saved: {output_file}")
+    plt.close()
+
+def plot_scaling_efficiency(summary, study, output_dir):
+    """
+    Parallel efficiency and Karp-Flatt serial fraction against the process count, one line
+    per implementation, from the scaling_summary.csv written by benchmark.py --scaling.
+
+    Args:
+        summary (DataFrame): The scaling summary
+        study (str): "strong" or "weak"
+        output_dir (str): Directory to save the plot
+    """
+    filtered = summary[summary['study'] == study]
+    if filtered.empty or filtered['processes'].nunique() <= 1:
+        print(f"Insufficient process counts for {study} scaling efficiency")
+        return
+
+    fig, (ax_eff, ax_serial) = plt.subplots(1, 2, figsize=(16, 8))
+    markers = ['o', 's', '^', 'D', 'v', '<', '>', 'p', '*', 'h']
+
+    # One series per implementation (and dataset, for strong scaling)
+    series = ['implementation', 'threads'] + (['dataset'] if study == 'strong' else [])
+    for i, (key, group) in enumerate(filtered.groupby(series)):
+        group = group.sort_values('processes')
+        label = key[0] if group['threads'].iloc[0] == 1 else f"{key[0]} ({key[1]} threads)"
+        if study == 'strong' and filtered['dataset'].nunique() > 1:
+            label += f", {os.path.basename(key[2])}"
+        color = COLORS[i % len(COLORS)]
+        marker = markers[i % len(markers)]
+
+        ax_eff.plot(group['processes'], group['efficiency'], marker=marker, color=color,
+                    linewidth=2, markersize=8, label=label)
+        for proc, efficiency in zip(group['processes'], group['efficiency']):
+            ax_eff.text(proc, efficiency + 0.02, f"{efficiency:.0%}", ha='center', va='bottom', fontsize=9)
+
+        serial = group[group['processes'] > 1]
+        ax_serial.plot(serial['processes'], serial['karp_flatt'], marker=marker, color=color,
+                       linewidth=2, markersize=8, label=label)
+
+        # Regressions against the baseline are circled in red
+        if 'regression' in group:
+            regressed = group[group['regression'] == True]
+            ax_eff.scatter(regressed['processes'], regressed['efficiency'], s=250, facecolors='none',
+                           edgecolors='red', linewidths=2, zorder=5)
+
+    ax_eff.axhline(1.0, color='black', linestyle='--', label='Ideal')
+    ax_eff.set_xlabel('Number of Processes', fontweight='bold')
+    ax_eff.set_ylabel('Parallel Efficiency', fontweight='bold')
+    ax_eff.set_title(f'{study.capitalize()} Scaling: Parallel Efficiency', fontweight='bold')
+    ax_eff.set_ylim(bottom=0)
+    ax_eff.legend(loc='lower left', framealpha=0.9)
+
+    ax_serial.set_xlabel('Number of Processes', fontweight='bold')
+    ax_serial.set_ylabel('Karp-Flatt Serial Fraction', fontweight='bold')
+    ax_serial.set_title(f'{study.capitalize()} Scaling: Experimentally Determined Serial Fraction',
+                        fontweight='bold')
+    ax_serial.legend(loc='upper left', framealpha=0.9)
+
+    for ax in (ax_eff, ax_serial):
+        if filtered['processes'].nunique() > 3:
+            ax.set_xscale('log', base=2)
+        ax.set_xticks(sorted(filtered['processes'].unique()))
+        ax.get_xaxis().set_major_formatter(plt.ScalarFormatter())
+        ax.yaxis.grid(True, linestyle='--', alpha=0.7)
+
+    plt.tight_layout(pad=2.0)
+
+    os.makedirs(output_dir, exist_ok=True)
+    output_file = os.path.join(output_dir, f"efficiency_{study}.png")
+    plt.savefig(output_file, dpi=300)
+    print(f"Saved: {output_file}")
+    plt.close()
+
+def generate_all_visualizations(df, output_dir, scaling_summary=None):
     """
     Generate all possible visualization combinations.
 
     Args:
         df (DataFrame): The benchmark results
         output_dir (str): Directory to save the plots
+        scaling_summary (DataFrame): Optional summary of benchmark.py --scaling
     """
     # Create output directories
     impl_dir = os.path.join(output_dir, "implementation_comparisons")
@@ -796,6 +932,21 @@ def generate_all_visualizations(df, output_dir):
         print(f"Processes: {processes}")
         plot_dataset_comparison_combined(df, processes, combined_dir)
 
+    # Per-phase breakdown for runs that wrote a profile
+    if any(column.startswith("phase_") for column in df.columns):
+        print("\n=== Generating Phase Breakdowns ===")
+        phase_dir = os.path.join(output_dir, "phase_breakdown")
+        for dataset in datasets:
+            for processes in process_counts:
+                plot_phase_breakdown(df, dataset, processes, phase_dir)
+
+    # Efficiency of scaling studies
+    if scaling_summary is not None and not scaling_summary.empty:
+        print("\n=== Generating Scaling Efficiency Plots ===")
+        efficiency_dir = os.path.join(output_dir, "scaling_efficiency")
+        for study in scaling_summary['study'].unique():
+            plot_scaling_efficiency(scaling_summary, study, efficiency_dir)
+
     print(f"\nAll visualizations saved to {output_dir}")
 
 def main():
@@ -805,6 +956,7 @@ def main():
     parser.add_argument('--implementation', '-i', help='Filter by implementation')
     parser.add_argument('--dataset', '-d', help='Filter by dataset')
     parser.add_argument('--processes', '-p', type=int, help='Filter by process count')
+    parser.add_argument('--scaling-summary', '-s', help='scaling_summary.csv of benchmark.py --scaling')
 
     args = parser.parse_args()
 
@@ -816,13 +968,15 @@ def main():
     # Read the CSV file
     df = pd.read_csv(args.csv_file)
 
+    scaling_summary = pd.read_csv(args.scaling_summary) if args.scaling_summary else None
+
     # Create output directory if it doesn't exist
     os.makedirs(args.output_dir, exist_ok=True)
 
     # Check if 'all' is specified
     if args.output_dir.lower() == 'all':
         output_dir = args.output_dir
-        generate_all_visualizations(df, output_dir)
+        generate_all_visualizations(df, output_dir, scaling_summary)
         return 0
 
     # Handle specific visualization requests
@@ -837,7 +991,7 @@ def main():
         plot_dataset_comparison(df, args.implementation, args.processes, args.output_dir)
     else:
         # Generate all visualizations
-        generate_all_visualizations(df, args.output_dir)
+        generate_all_visualizations(df, args.output_dir, scaling_summary)
 
     return 0
 
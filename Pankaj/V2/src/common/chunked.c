@@ -0,0 +1,436 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "chunked.h"
+#include "profile.h"
+#include "placement.h"
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+int readChunkedHeader(const char* path, ChunkedHeader* header) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return 0;
+    size_t got = fread(header, sizeof(*header), 1, fp);
+    fclose(fp);
+    if (got != 1 || memcmp(header->magic, CHUNKED_MAGIC, 8) != 0) return 0;
+    return (header->version == CHUNKED_VERSION && header->codec == CHUNKED_CODEC_NONE) ||
+           (header->version == CHUNKED_VERSION_COMPRESSED && header->codec != CHUNKED_CODEC_NONE);
+}
+
+const char* chunkedCodecName(int codec) {
+    switch (codec) {
+        case CHUNKED_CODEC_NONE: return "none";
+        case CHUNKED_CODEC_SHUFFLE_ZLIB: return "shuffle+zlib";
+        default: return "unknown";
+    }
+}
+
+bool chunkedCodecSupported(int codec) {
+#ifdef HAVE_ZLIB
+    if (codec == CHUNKED_CODEC_SHUFFLE_ZLIB) return true;
+#endif
+    return codec == CHUNKED_CODEC_NONE;
+}
+
+void chunkedBrickCounts(const ChunkedHeader* header, int counts[3]) {
+    counts[0] = (header->nX + header->brickX - 1) / header->brickX;
+    counts[1] = (header->nY + header->brickY - 1) / header->brickY;
+    counts[2] = (header->nZ + header->brickZ - 1) / header->brickZ;
+}
+
+// Global origin and extent of brick (bx, by, bz)
+static void brickExtent(const ChunkedHeader* header, int bx, int by, int bz, int lo[3], int size[3]) {
+    const int brick[3] = {header->brickX, header->brickY, header->brickZ};
+    const int n[3] = {header->nX, header->nY, header->nZ};
+    const int b[3] = {bx, by, bz};
+    for (int d = 0; d < 3; d++) {
+        lo[d] = b[d] * brick[d];
+        size[d] = n[d] - lo[d] < brick[d] ? n[d] - lo[d] : brick[d];
+    }
+}
+
+static long roundUp(long value, long alignment) {
+    return alignment > 0 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+#ifdef HAVE_ZLIB
+// Byte k of every value together: the exponent and high mantissa bytes of a smooth field
+// become long runs that deflate far better than the interleaved values
+static void shuffleBytes(const char* src, char* dst, long values, int elementSize) {
+    for (long i = 0; i < values; i++) {
+        for (int k = 0; k < elementSize; k++) dst[k * values + i] = src[i * elementSize + k];
+    }
+}
+
+static void unshuffleBytes(const char* src, char* dst, long values, int elementSize) {
+    for (int k = 0; k < elementSize; k++) {
+        const char* plane = src + k * values;
+        for (long i = 0; i < values; i++) dst[i * elementSize + k] = plane[i];
+    }
+}
+
+// Encoded size of a brick of the given bytes in the worst case
+static long compressedBound(long bytes) {
+    return (long)compressBound((uLong)bytes);
+}
+
+// Encode a brick into out (scratch holds bytes); the encoded size, or -1 on failure
+static long encodeBrick(const char* brick, long bytes, int elementSize, char* scratch, char* out, long outCapacity) {
+    shuffleBytes(brick, scratch, bytes / elementSize, elementSize);
+    uLongf outBytes = (uLongf)outCapacity;
+    if (compress2((Bytef*)out, &outBytes, (const Bytef*)scratch, (uLong)bytes, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return -1;
+    }
+    return (long)outBytes;
+}
+
+// Decode an encoded brick into brick (bytes long, scratch holds bytes); false if it is damaged
+static bool decodeBrick(const char* encoded, long encodedBytes, int elementSize, char* scratch, char* brick,
+                        long bytes) {
+    uLongf outBytes = (uLongf)bytes;
+    if (uncompress((Bytef*)scratch, &outBytes, (const Bytef*)encoded, (uLong)encodedBytes) != Z_OK ||
+        (long)outBytes != bytes) {
+        return false;
+    }
+    unshuffleBytes(scratch, brick, bytes / elementSize, elementSize);
+    return true;
+}
+#else
+// Without zlib only uncompressed files get past chunkedCodecSupported
+static long compressedBound(long bytes) { return bytes; }
+static long encodeBrick(const char* brick, long bytes, int elementSize, char* scratch, char* out, long outCapacity) {
+    return -1;
+}
+static bool decodeBrick(const char* encoded, long encodedBytes, int elementSize, char* scratch, char* brick,
+                        long bytes) {
+    return false;
+}
+#endif
+
+bool writeChunkedFile(const char* path, const void* data, int elementSize, int nX, int nY, int nZ,
+                      int timeSteps, const int brick[3], long alignment, int codec) {
+    if (!chunkedCodecSupported(codec)) {
+        printf("Error: this build cannot write %s bricks\n", chunkedCodecName(codec));
+        return false;
+    }
+
+    ChunkedHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHUNKED_MAGIC, 8);
+    header.version = codec == CHUNKED_CODEC_NONE ? CHUNKED_VERSION : CHUNKED_VERSION_COMPRESSED;
+    header.codec = codec;
+    header.dtype = elementSize == sizeof(double) ? 1 : 0;
+    header.nX = nX;
+    header.nY = nY;
+    header.nZ = nZ;
+    header.timeSteps = timeSteps;
+    header.brickX = brick[0];
+    header.brickY = brick[1];
+    header.brickZ = brick[2];
+    header.alignment = alignment;
+
+    int counts[3];
+    chunkedBrickCounts(&header, counts);
+    const long bricks = (long)counts[0] * counts[1] * counts[2];
+    const long seriesBytes = (long)timeSteps * elementSize;
+    const long brickBytes = (long)brick[0] * brick[1] * brick[2] * seriesBytes;
+    const long indexBytes = bricks * timeSteps * 2 * (long)sizeof(double);
+    header.indexOffset = sizeof(header);
+    if (codec == CHUNKED_CODEC_NONE) {
+        header.dataOffset = roundUp(header.indexOffset + indexBytes, alignment);
+        header.brickStride = roundUp(brickBytes, alignment);
+    } else {
+        // Compressed bricks vary in size: the directory after the index locates them
+        header.dataOffset = roundUp(header.indexOffset + indexBytes + bricks * 2 * (long)sizeof(int64_t), alignment);
+        header.brickStride = brickBytes;
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        printf("Error: Cannot create %s\n", path);
+        return false;
+    }
+
+    double* index = (double*)malloc(bricks * timeSteps * 2 * sizeof(double));
+    char* packed = (char*)malloc(header.brickStride);
+    int64_t* directory = NULL;
+    char* scratch = NULL;
+    char* encoded = NULL;
+    const long encodedCapacity = compressedBound(brickBytes);
+    if (codec != CHUNKED_CODEC_NONE) {
+        directory = (int64_t*)malloc(bricks * 2 * sizeof(int64_t));
+        scratch = (char*)malloc(brickBytes);
+        encoded = (char*)malloc(encodedCapacity);
+    }
+    if (!index || !packed || (codec != CHUNKED_CODEC_NONE && (!directory || !scratch || !encoded))) {
+        printf("Failed to allocate the brick buffers\n");
+        free(index);
+        free(packed);
+        free(directory);
+        free(scratch);
+        free(encoded);
+        fclose(fp);
+        return false;
+    }
+
+    const char* bytes = (const char*)data;
+    long cursor = header.dataOffset;
+    bool ok = true;
+    for (int bz = 0; bz < counts[2] && ok; bz++) {
+        for (int by = 0; by < counts[1] && ok; by++) {
+            for (int bx = 0; bx < counts[0] && ok; bx++) {
+                const long b = ((long)bz * counts[1] + by) * counts[0] + bx;
+                int lo[3], size[3];
+                brickExtent(&header, bx, by, bz, lo, size);
+
+                // Pack the brick and fold its values into the index entry
+                double* entry = index + b * timeSteps * 2;
+                for (int t = 0; t < timeSteps; t++) {
+                    entry[2 * t] = DBL_MAX;
+                    entry[2 * t + 1] = -DBL_MAX;
+                }
+                long rowBytes = size[0] * seriesBytes;
+                char* dst = packed;
+                for (int z = lo[2]; z < lo[2] + size[2]; z++) {
+                    for (int y = lo[1]; y < lo[1] + size[1]; y++) {
+                        const char* src = bytes + (long)getLinearIndex(lo[0], y, z, nX, nY, nZ) * seriesBytes;
+                        memcpy(dst, src, rowBytes);
+                        for (long i = 0; i < (long)size[0] * timeSteps; i++) {
+                            double v = elementSize == sizeof(double) ? ((const double*)src)[i] : ((const float*)src)[i];
+                            int t = (int)(i % timeSteps);
+                            if (v < entry[2 * t]) entry[2 * t] = v;
+                            if (v > entry[2 * t + 1]) entry[2 * t + 1] = v;
+                        }
+                        dst += rowBytes;
+                    }
+                }
+
+                long packedBytes = dst - packed;
+                if (codec == CHUNKED_CODEC_NONE) {
+                    ok = fseek(fp, header.dataOffset + b * header.brickStride, SEEK_SET) == 0 &&
+                         fwrite(packed, 1, packedBytes, fp) == (size_t)packedBytes;
+                } else {
+                    long encodedBytes = encodeBrick(packed, packedBytes, elementSize, scratch, encoded, encodedCapacity);
+                    ok = encodedBytes >= 0 && fseek(fp, cursor, SEEK_SET) == 0 &&
+                         fwrite(encoded, 1, encodedBytes, fp) == (size_t)encodedBytes;
+                    directory[2 * b] = cursor;
+                    directory[2 * b + 1] = encodedBytes;
+                    cursor += encodedBytes;
+                }
+            }
+        }
+    }
+
+    ok = ok && fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1 &&
+         fwrite(index, sizeof(double), bricks * timeSteps * 2, fp) == (size_t)(bricks * timeSteps * 2);
+    if (codec != CHUNKED_CODEC_NONE) {
+        ok = ok && fwrite(directory, sizeof(int64_t), bricks * 2, fp) == (size_t)(bricks * 2);
+    }
+    if (!ok) printf("Error: writing %s failed\n", path);
+
+    free(index);
+    free(packed);
+    free(directory);
+    free(scratch);
+    free(encoded);
+    fclose(fp);
+    return ok;
+}
+
+// Copy the part of a brick that lies in the padded block
+static void copyBrick(const ChunkedHeader* header, const char* brickData, const int lo[3], const int size[3],
+                      const SubDomain* subdomain, char* localData) {
+    const long seriesBytes = (long)header->timeSteps * (header->dtype ? sizeof(double) : sizeof(float));
+    int x0 = lo[0] > subdomain->tempStartX ? lo[0] : subdomain->tempStartX;
+    int y0 = lo[1] > subdomain->tempStartY ? lo[1] : subdomain->tempStartY;
+    int z0 = lo[2] > subdomain->tempStartZ ? lo[2] : subdomain->tempStartZ;
+    int x1 = lo[0] + size[0] - 1 < subdomain->tempEndX ? lo[0] + size[0] - 1 : subdomain->tempEndX;
+    int y1 = lo[1] + size[1] - 1 < subdomain->tempEndY ? lo[1] + size[1] - 1 : subdomain->tempEndY;
+    int z1 = lo[2] + size[2] - 1 < subdomain->tempEndZ ? lo[2] + size[2] - 1 : subdomain->tempEndZ;
+
+    const long rowBytes = (long)(x1 - x0 + 1) * seriesBytes;
+    for (int z = z0; z <= z1; z++) {
+        for (int y = y0; y <= y1; y++) {
+            long src = ((long)(z - lo[2]) * size[1] + (y - lo[1])) * size[0] + (x0 - lo[0]);
+            long dst = ((long)(z - subdomain->tempStartZ) * subdomain->tempHeight + (y - subdomain->tempStartY)) *
+                       subdomain->tempWidth + (x0 - subdomain->tempStartX);
+            memcpy(localData + dst * seriesBytes, brickData + src * seriesBytes, rowBytes);
+        }
+    }
+}
+
+void* readChunkedBlock(const char* path, const ChunkedHeader* header, const SubDomain* subdomain, MPI_Comm comm) {
+    const int elementSize = header->dtype ? sizeof(double) : sizeof(float);
+    const long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                               subdomain->tempDepth * header->timeSteps;
+    const bool compressed = header->codec != CHUNKED_CODEC_NONE;
+
+    if (!chunkedCodecSupported(header->codec)) {
+        printf("Error: %s has %s bricks, rebuild with COMPRESSION=zlib\n", path, chunkedCodecName(header->codec));
+        return NULL;
+    }
+
+    // Bricks overlapping the padded block
+    int first[3], last[3], counts[3], all[3];
+    const int brick[3] = {header->brickX, header->brickY, header->brickZ};
+    const int tempStart[3] = {subdomain->tempStartX, subdomain->tempStartY, subdomain->tempStartZ};
+    const int tempEnd[3] = {subdomain->tempEndX, subdomain->tempEndY, subdomain->tempEndZ};
+    int wanted = 1;
+    for (int d = 0; d < 3; d++) {
+        first[d] = tempStart[d] / brick[d];
+        last[d] = tempEnd[d] / brick[d];
+        counts[d] = last[d] - first[d] + 1;
+        wanted *= counts[d];
+    }
+    chunkedBrickCounts(header, all);
+    const long bricks = (long)all[0] * all[1] * all[2];
+
+    char* localData = (char*)allocateLocalBlock(subdomain, localDataSize * elementSize);
+    MPI_Request* requests = (MPI_Request*)malloc(wanted * sizeof(MPI_Request));
+    MPI_Offset* fileOffsets = (MPI_Offset*)malloc(wanted * sizeof(MPI_Offset));
+    long* slots = (long*)malloc((wanted + 1) * sizeof(long));
+    int64_t* directory = compressed ? (int64_t*)malloc(bricks * 2 * sizeof(int64_t)) : NULL;
+    char* inflated = compressed ? (char*)malloc(2 * header->brickStride) : NULL;
+    if (!localData || !requests || !fileOffsets || !slots || (compressed && (!directory || !inflated))) {
+        printf("Failed to allocate memory for local data\n");
+        free(localData);
+        free(requests);
+        free(fileOffsets);
+        free(slots);
+        free(directory);
+        free(inflated);
+        return NULL;
+    }
+
+    MPI_File fh;
+    profileBegin(PROFILE_OPEN);
+    int ret = MPI_File_open(comm, path, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    profileEnd(PROFILE_OPEN, 0);
+    if (ret != MPI_SUCCESS) {
+        char error_string[MPI_MAX_ERROR_STRING];
+        int length_of_error_string;
+        MPI_Error_string(ret, error_string, &length_of_error_string);
+        printf("Error opening file: %s\n", error_string);
+        free(localData);
+        free(requests);
+        free(fileOffsets);
+        free(slots);
+        free(directory);
+        free(inflated);
+        return NULL;
+    }
+
+    // The brick directory is small next to the data: every rank reads it whole
+    profileBegin(PROFILE_READ);
+    double readBytes = 0;
+    if (compressed) {
+        MPI_Offset directoryOffset = header->indexOffset + bricks * header->timeSteps * 2 * (MPI_Offset)sizeof(double);
+        MPI_File_read_at_all(fh, directoryOffset, directory, (int)(bricks * 2), MPI_INT64_T, MPI_STATUS_IGNORE);
+        readBytes += bricks * 2 * sizeof(int64_t);
+    }
+
+    // Where each wanted brick is in the file and in the receive buffer
+    slots[0] = 0;
+    for (int i = 0; i < wanted; i++) {
+        int bx = first[0] + i % counts[0];
+        int by = first[1] + (i / counts[0]) % counts[1];
+        int bz = first[2] + i / (counts[0] * counts[1]);
+        int lo[3], size[3];
+        brickExtent(header, bx, by, bz, lo, size);
+
+        long b = ((long)bz * all[1] + by) * all[0] + bx;
+        long bytes = (long)size[0] * size[1] * size[2] * header->timeSteps * elementSize;
+        if (compressed) {
+            fileOffsets[i] = directory[2 * b];
+            bytes = directory[2 * b + 1];
+        } else {
+            fileOffsets[i] = header->dataOffset + b * header->brickStride;
+        }
+        slots[i + 1] = slots[i] + bytes;
+    }
+
+    char* brickData = (char*)malloc(slots[wanted] > 0 ? slots[wanted] : 1);
+    int ok = brickData != NULL;
+    if (!ok) printf("Failed to allocate memory for %d bricks\n", wanted);
+
+    // One request per brick, all in flight together; decode and copy each out as it lands
+    for (int i = 0; i < wanted && ok; i++) {
+        int bytes = (int)(slots[i + 1] - slots[i]);
+        MPI_File_iread_at(fh, fileOffsets[i], brickData + slots[i], bytes, MPI_BYTE, &requests[i]);
+        readBytes += bytes;
+    }
+    profileEnd(PROFILE_READ, readBytes);
+
+    for (int done = 0; done < wanted && ok; done++) {
+        int i;
+        profileBegin(PROFILE_READ);
+        MPI_Waitany(wanted, requests, &i, MPI_STATUS_IGNORE);
+        profileEnd(PROFILE_READ, 0);
+
+        int bx = first[0] + i % counts[0];
+        int by = first[1] + (i / counts[0]) % counts[1];
+        int bz = first[2] + i / (counts[0] * counts[1]);
+        int lo[3], size[3];
+        brickExtent(header, bx, by, bz, lo, size);
+
+        const char* src = brickData + slots[i];
+        if (compressed) {
+            long bytes = (long)size[0] * size[1] * size[2] * header->timeSteps * elementSize;
+            profileBegin(PROFILE_DECOMPRESS);
+            if (!decodeBrick(src, slots[i + 1] - slots[i], elementSize, inflated + header->brickStride, inflated,
+                             bytes)) {
+                printf("Error: brick (%d, %d, %d) of %s is damaged\n", bx, by, bz, path);
+                ok = 0;
+            }
+            profileEnd(PROFILE_DECOMPRESS, bytes);
+            src = inflated;
+        }
+
+        profileBegin(PROFILE_PACK);
+        if (ok) copyBrick(header, src, lo, size, subdomain, localData);
+        profileEnd(PROFILE_PACK, 0);
+    }
+
+    // A damaged brick leaves the others to land before the buffer goes
+    if (brickData && !ok) MPI_Waitall(wanted, requests, MPI_STATUSES_IGNORE);
+
+    MPI_File_close(&fh);
+    free(brickData);
+    free(requests);
+    free(fileOffsets);
+    free(slots);
+    free(directory);
+    free(inflated);
+    if (!ok) {
+        free(localData);
+        return NULL;
+    }
+    return localData;
+}
+
+bool chunkedGlobalExtrema(const char* path, const ChunkedHeader* header, TimeSeriesResults* results) {
+    int counts[3];
+    chunkedBrickCounts(header, counts);
+    const long entries = (long)counts[0] * counts[1] * counts[2] * header->timeSteps * 2;
+
+    double* index = (double*)malloc(entries * sizeof(double));
+    FILE* fp = fopen(path, "rb");
+    bool ok = index && fp && fseek(fp, header->indexOffset, SEEK_SET) == 0 &&
+              fread(index, sizeof(double), entries, fp) == (size_t)entries;
+    if (fp) fclose(fp);
+    if (!ok) {
+        printf("Error: cannot read the brick index of %s\n", path);
+        free(index);
+        return false;
+    }
+
+    for (long e = 0; e < entries; e += 2) {
+        int t = (int)((e / 2) % header->timeSteps);
+        if (index[e] < results->minValues[t]) results->minValues[t] = index[e];
+        if (index[e + 1] > results->maxValues[t]) results->maxValues[t] = index[e + 1];
+    }
+    free(index);
+    return true;
+}
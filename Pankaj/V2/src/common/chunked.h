@@ -0,0 +1,67 @@
+#ifndef CHUNKED_H
+#define CHUNKED_H
+
+#include <stdint.h>
+#include "mpi.h"
+#include "timeseries.h"
+
+// Self-describing chunked dataset (native byte order):
+//   header | index | bricks
+// The domain is cut into bricks of brickX x brickY x brickZ points (smaller at the high
+// edges); brick (bx, by, bz) is stored at dataOffset + ((bz * bricksY + by) * bricksX + bx)
+// * brickStride as [z][y][x][t] over its own extent, so one aligned request fetches it.
+// brickStride and dataOffset are multiples of alignment (the file system stripe; 0 = packed).
+// The index holds, per brick and timestep, the {min, max} of the brick as doubles.
+//
+// Version 2 files have compressed bricks (codec != CHUNKED_CODEC_NONE): the index is followed
+// by a directory of {int64 offset, int64 bytes} per brick in the same order, and the bricks
+// are packed back to back from dataOffset (only dataOffset is aligned). brickStride is then
+// the uncompressed size of a full brick. CHUNKED_CODEC_SHUFFLE_ZLIB byte-shuffles a brick
+// (byte k of every value together) and deflates it; it needs a build with COMPRESSION=zlib.
+#define CHUNKED_MAGIC "TSCHUNK1"
+#define CHUNKED_VERSION 1
+#define CHUNKED_VERSION_COMPRESSED 2
+
+#define CHUNKED_CODEC_NONE 0
+#define CHUNKED_CODEC_SHUFFLE_ZLIB 1
+
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t dtype;            // 0 = float32, 1 = float64
+    int32_t nX, nY, nZ, timeSteps;
+    int32_t brickX, brickY, brickZ;
+    int32_t codec;            // CHUNKED_CODEC_*, 0 in version 1 files
+    int64_t alignment;
+    int64_t indexOffset;      // bricks * timeSteps * {min, max}
+    int64_t dataOffset;       // first brick
+    int64_t brickStride;      // bytes between consecutive bricks
+} ChunkedHeader;
+
+// 1 if path starts with a chunked header (filled in), 0 otherwise (including unreadable files)
+int readChunkedHeader(const char* path, ChunkedHeader* header);
+
+// Name of a codec for messages ("none", "shuffle+zlib", "unknown")
+const char* chunkedCodecName(int codec);
+
+// Whether this build can read and write bricks with codec
+bool chunkedCodecSupported(int codec);
+
+// Number of bricks along x, y, z
+void chunkedBrickCounts(const ChunkedHeader* header, int counts[3]);
+
+// Write data ([z][y][x][t], elementSize 4 or 8) as a chunked file with the given brick
+// size, alignment (0 = packed) and codec. False if the file cannot be written.
+bool writeChunkedFile(const char* path, const void* data, int elementSize, int nX, int nY, int nZ,
+                      int timeSteps, const int brick[3], long alignment, int codec);
+
+// Collective over comm: read every brick overlapping the padded block (one non-blocking
+// request each, all in flight) and assemble the block [z][y][x][t] in the file's type.
+// Compressed bricks are inflated as they land, while the others are still in flight.
+// NULL on failure; the caller frees.
+void* readChunkedBlock(const char* path, const ChunkedHeader* header, const SubDomain* subdomain, MPI_Comm comm);
+
+// Global min/max per timestep from the index alone (no scan of the data)
+bool chunkedGlobalExtrema(const char* path, const ChunkedHeader* header, TimeSeriesResults* results);
+
+#endif // CHUNKED_H
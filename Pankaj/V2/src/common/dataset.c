@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dataset.h"
+
+// 0: no side-car, 1: parsed into *isDouble, -1: present but unusable
+static int readSideCar(const ProgramArgs* args, int* isDouble) {
+    char path[300];
+    snprintf(path, sizeof(path), "%s.meta", args->inputFile);
+    FILE* fp = fopen(path, "r");
+    if (!fp) return 0;
+
+    int result = -1;
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "#\r\n")] = '\0';
+        char* equals = strchr(line, '=');
+        if (!equals) continue;
+        *equals = '\0';
+        const char* key = line;
+        const char* value = equals + 1;
+
+        if (strcmp(key, "dtype") == 0) {
+            if (strcmp(value, "float32") == 0) { *isDouble = 0; result = 1; }
+            else if (strcmp(value, "float64") == 0) { *isDouble = 1; result = 1; }
+            else {
+                printf("Error: %s: unknown dtype %s\n", path, value);
+                result = -2;
+                break;
+            }
+            continue;
+        }
+
+        int expected = -1;
+        if (strcmp(key, "nx") == 0) expected = args->nX;
+        else if (strcmp(key, "ny") == 0) expected = args->nY;
+        else if (strcmp(key, "nz") == 0) expected = args->nZ;
+        else if (strcmp(key, "timesteps") == 0) expected = args->timeSteps;
+        if (expected >= 0 && atoi(value) != expected) {
+            printf("Error: %s: %s=%s but the command line says %d\n", path, key, value, expected);
+            result = -2;
+            break;
+        }
+    }
+    fclose(fp);
+
+    // -2 marks errors already reported
+    if (result == -1) printf("Error: %s has no dtype line\n", path);
+    return result < 0 ? -1 : result;
+}
+
+// Element size implied by the file length (0 if it matches neither type)
+static int sizeFromFileLength(const ProgramArgs* args) {
+    FILE* fp = fopen(args->inputFile, "rb");
+    if (!fp) {
+        printf("Failed to open input file: %s\n", args->inputFile);
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fclose(fp);
+
+    const long values = (long)args->nX * args->nY * args->nZ * args->timeSteps;
+    if (length == values * (long)sizeof(float)) return sizeof(float);
+    if (length == values * (long)sizeof(double)) return sizeof(double);
+    printf("Error: %s has %ld bytes, expected %ld (float32) or %ld (float64)\n",
+           args->inputFile, length, values * (long)sizeof(float), values * (long)sizeof(double));
+    return 0;
+}
+
+bool datasetElementType(const ProgramArgs* args, MPI_Comm comm, MPI_Datatype* elementType) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Rank 0 decides; -1 means failure
+    int isDouble = -1;
+    if (rank == 0) {
+        const char* source = "side-car";
+        int found = readSideCar(args, &isDouble);
+        if (found < 0) {
+            isDouble = -1;
+        } else if (found == 0) {
+            source = "file size";
+            int size = sizeFromFileLength(args);
+            isDouble = size == sizeof(double) ? 1 : size == sizeof(float) ? 0 : -1;
+        }
+        if (isDouble >= 0) {
+            printf("Element type: %s (%s)\n", isDouble ? "float64" : "float32", source);
+        }
+    }
+    MPI_Bcast(&isDouble, 1, MPI_INT, 0, comm);
+
+    if (isDouble < 0) return false;
+    *elementType = isDouble ? MPI_DOUBLE : MPI_FLOAT;
+    return true;
+}
+
+bool writeDatasetMeta(const char* dataFile, int nX, int nY, int nZ, int timeSteps, MPI_Datatype elementType) {
+    char path[300];
+    snprintf(path, sizeof(path), "%s.meta", dataFile);
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        printf("Error: Cannot create %s\n", path);
+        return false;
+    }
+    fprintf(fp, "dtype=%s\nnx=%d\nny=%d\nnz=%d\ntimesteps=%d\n",
+            elementType == MPI_DOUBLE ? "float64" : "float32", nX, nY, nZ, timeSteps);
+    fclose(fp);
+    return true;
+}
+
+void analyzeLocalDataAs(MPI_Datatype elementType, void* localData, const SubDomain* subdomain,
+                        TimeSeriesResults* results, const ProgramArgs* args) {
+    if (elementType == MPI_DOUBLE) {
+        analyzeLocalDataDouble((double*)localData, subdomain, results, args);
+    } else {
+        analyzeLocalData((float*)localData, subdomain, results, args);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Element type of a dataset. A side-car "<data file>.meta" holds key=value lines:
+//   dtype=float32|float64    (required)
+//   nx=, ny=, nz=, timesteps= (optional, checked against the command line)
+// Without a side-car the type follows from the file size and the dimensions.
+// Chunked files (chunked.h) carry the type in their header and are read by chunkedIO only.
+
+// Collective over comm: MPI_FLOAT or MPI_DOUBLE in *elementType, printed on rank 0.
+// False (on every rank) if the side-car is invalid or the file size fits neither type.
+bool datasetElementType(const ProgramArgs* args, MPI_Comm comm, MPI_Datatype* elementType);
+
+// Write the side-car for dataFile; false if it cannot be created
+bool writeDatasetMeta(const char* dataFile, int nX, int nY, int nZ, int timeSteps, MPI_Datatype elementType);
+
+// analyzeLocalData or analyzeLocalDataDouble, whichever matches elementType
+void analyzeLocalDataAs(MPI_Datatype elementType, void* localData, const SubDomain* subdomain,
+                        TimeSeriesResults* results, const ProgramArgs* args);
+
+#endif // DATASET_H
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "device.h"
+#include "extrema_gpu.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+
+// Offload sweeps: one instantiation per element type
+#define KERNEL_REAL float
+#define KERNEL_NAME(base) base
+#include "extrema_offload.h"
+#undef KERNEL_REAL
+#undef KERNEL_NAME
+
+#define KERNEL_REAL double
+#define KERNEL_NAME(base) base##Double
+#include "extrema_offload.h"
+#undef KERNEL_REAL
+#undef KERNEL_NAME
+#endif
+
+const char* deviceName(DeviceKind device) {
+    switch (device) {
+        case DEVICE_CPU: return "cpu";
+        case DEVICE_GPU: return "gpu";
+        case DEVICE_OFFLOAD: return "offload";
+    }
+    return "unknown";
+}
+
+// Rank within the node as the common launchers export it, rank if none does
+static int nodeLocalRank(int rank) {
+    const char* names[] = {"OMPI_COMM_WORLD_LOCAL_RANK", "MPI_LOCALRANKID", "SLURM_LOCALID", "PMI_LOCAL_RANK"};
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        const char* value = getenv(names[i]);
+        if (value && *value) return atoi(value);
+    }
+    return rank;
+}
+
+bool deviceInit(DeviceKind device, int rank, const char** note) {
+    *note = NULL;
+    const int localRank = nodeLocalRank(rank);
+    (void)localRank;
+
+    switch (device) {
+        case DEVICE_CPU:
+            return true;
+
+        case DEVICE_GPU:
+#ifdef HAVE_GPU
+            if (gpuSelectDevice(localRank) > 0) {
+                *note = "experimental, not yet run on hardware; check results against --device=cpu";
+                return true;
+            }
+            *note = "no GPU visible to this process";
+#else
+            *note = "built without GPU=cuda|hip";
+#endif
+            return false;
+
+        case DEVICE_OFFLOAD:
+#ifdef _OPENMP
+            if (omp_get_num_devices() > 0) {
+                omp_set_default_device(localRank % omp_get_num_devices());
+            } else {
+                *note = "no offload device, the target regions run on the host";
+            }
+            return true;
+#else
+            *note = "needs an OpenMP build (the _omp binaries)";
+            return false;
+#endif
+    }
+    return false;
+}
+
+// The padded block and the box in the form the device sweeps take
+static inline DeviceBlock deviceBlock(const SubDomain* subdomain, const LocalBox* box, int timeSteps) {
+    DeviceBlock block;
+    block.width = subdomain->tempWidth;
+    block.height = subdomain->tempHeight;
+    block.depth = subdomain->tempDepth;
+    block.timeSteps = timeSteps;
+    block.x0 = box->x0;
+    block.x1 = box->x1;
+    block.y0 = box->y0;
+    block.y1 = box->y1;
+    block.z0 = box->z0;
+    block.z1 = box->z1;
+    return block;
+}
+
+bool deviceAnalyzeBox(const void* localData, bool isDouble, const SubDomain* subdomain, const LocalBox* box,
+                      TimeSeriesResults* results, int timeSteps, DeviceKind device) {
+    if (isEmptyBox(box)) return true;
+
+    // The device fills results of its own, merged only if the whole sweep succeeded
+    TimeSeriesResults* partial = allocateResults(timeSteps);
+    if (!partial) return false;
+
+    bool ok = false;
+    switch (device) {
+        case DEVICE_GPU:
+#ifdef HAVE_GPU
+        {
+            DeviceBlock block = deviceBlock(subdomain, box, timeSteps);
+            ok = gpuSweepBlock(localData, isDouble ? sizeof(double) : sizeof(float), &block, partial->minimaCount,
+                               partial->maximaCount, partial->minValues, partial->maxValues) != 0;
+        }
+#endif
+            break;
+
+        case DEVICE_OFFLOAD:
+#ifdef _OPENMP
+        {
+            DeviceBlock block = deviceBlock(subdomain, box, timeSteps);
+            if (isDouble) {
+                offloadSweepDouble((const double*)localData, &block, partial->minimaCount, partial->maximaCount,
+                                   partial->minValues, partial->maxValues);
+            } else {
+                offloadSweep((const float*)localData, &block, partial->minimaCount, partial->maximaCount,
+                             partial->minValues, partial->maxValues);
+            }
+            ok = true;
+        }
+#endif
+            break;
+
+        case DEVICE_CPU:
+            break;
+    }
+
+    if (ok) mergeResults(results, partial, timeSteps);
+    freeResults(partial);
+    return ok;
+}
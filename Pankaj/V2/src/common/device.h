@@ -0,0 +1,27 @@
+#ifndef DEVICE_H
+#define DEVICE_H
+
+#include <stdbool.h>
+#include "timeseries.h"
+
+// Accelerated extrema sweep behind --device. The padded point-major block goes to the
+// device as it is, one fused min/max/extrema pass runs there with block-level reductions,
+// and only the per-timestep results come back.
+//   gpu      CUDA or HIP kernel in extrema_gpu.cu (make GPU=cuda or GPU=hip)
+//   offload  OpenMP target regions (the _omp builds); without an offload device the
+//            OpenMP runtime runs them on the host
+
+// Name of a device kind for messages ("cpu", "gpu", "offload")
+const char* deviceName(DeviceKind device);
+
+// Prepare device for this rank: a GPU is picked by node-local rank (rank if the launcher
+// does not say). False if this build or node cannot run it; *note then says why, and is
+// otherwise NULL or a remark worth printing.
+bool deviceInit(DeviceKind device, int rank, const char** note);
+
+// Sweep box of a point-major padded block on device and accumulate the result into
+// results. False if the device path failed, in which case results are untouched.
+bool deviceAnalyzeBox(const void* localData, bool isDouble, const SubDomain* subdomain, const LocalBox* box,
+                      TimeSeriesResults* results, int timeSteps, DeviceKind device);
+
+#endif // DEVICE_H
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "distribute.h"
+#include "profile.h"
+
+MPI_Datatype createBlockType(const SubDomain* block, int nX, int nY, int nZ, int timeSteps,
+                             MPI_Datatype elementType) {
+    int globalSizes[4] = {nZ, nY, nX, timeSteps};
+    int subSizes[4] = {block->tempDepth, block->tempHeight, block->tempWidth, timeSteps};
+    int starts[4] = {block->tempStartZ, block->tempStartY, block->tempStartX, 0};
+
+    MPI_Datatype blockType;
+    MPI_Type_create_subarray(4, globalSizes, subSizes, starts, MPI_ORDER_C, elementType, &blockType);
+    MPI_Type_commit(&blockType);
+    return blockType;
+}
+
+SubDomain wholeDomainView(const SubDomain* subdomain, int nX, int nY, int nZ) {
+    SubDomain view = *subdomain;
+    view.tempStartX = 0;
+    view.tempStartY = 0;
+    view.tempStartZ = 0;
+    view.tempEndX = nX - 1;
+    view.tempEndY = nY - 1;
+    view.tempEndZ = nZ - 1;
+    view.tempWidth = nX;
+    view.tempHeight = nY;
+    view.tempDepth = nZ;
+    return view;
+}
+
+bool rootAnalysesInPlace(const ProgramArgs* args) {
+    // The time-major and SIMD paths transpose their block first and the device paths
+    // upload it, which would be the whole domain
+    return args->layout == LAYOUT_POINT_MAJOR && args->kernel != KERNEL_SIMD &&
+           args->device == DEVICE_CPU;
+}
+
+bool scatterBlocks(const void* globalData, void* localData, MPI_Datatype elementType,
+                   const SubDomain* subdomain, const ProgramArgs* args, bool rootInPlace, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    int* counts = (int*)calloc(4 * (size_t)size, sizeof(int));
+    MPI_Datatype* types = (MPI_Datatype*)malloc(2 * (size_t)size * sizeof(MPI_Datatype));
+    if (!counts || !types) {
+        printf("Rank %d: Failed to allocate the scatter descriptors\n", rank);
+        free(counts);
+        free(types);
+        return false;
+    }
+
+    // Displacements stay 0: each send type already carries its block's offset in globalData
+    int* sendCounts = counts;
+    int* recvCounts = counts + size;
+    int* sendDispls = counts + 2 * size;
+    int* recvDispls = counts + 3 * size;
+    MPI_Datatype* sendTypes = types;
+    MPI_Datatype* recvTypes = types + size;
+
+    for (int p = 0; p < size; p++) {
+        sendTypes[p] = elementType;
+        recvTypes[p] = elementType;
+    }
+
+    if (rank == 0) {
+        for (int p = rootInPlace ? 1 : 0; p < size; p++) {
+            SubDomain block;
+            calculateSubDomainBoundaries(p, args->pX, args->pY, args->pZ, args->nX, args->nY, args->nZ, &block);
+            sendTypes[p] = createBlockType(&block, args->nX, args->nY, args->nZ, args->timeSteps, elementType);
+            sendCounts[p] = 1;
+        }
+    }
+
+    if (rank != 0 || !rootInPlace) {
+        recvCounts[0] = subdomain->tempWidth * subdomain->tempHeight * subdomain->tempDepth * args->timeSteps;
+    }
+
+    int elementSize;
+    MPI_Type_size(elementType, &elementSize);
+    profileBegin(PROFILE_SEND);
+    MPI_Alltoallw(globalData, sendCounts, sendDispls, sendTypes,
+                  localData, recvCounts, recvDispls, recvTypes, comm);
+    profileEnd(PROFILE_SEND, (double)recvCounts[0] * elementSize);
+
+    for (int p = 0; p < size; p++) {
+        if (sendCounts[p] > 0) MPI_Type_free(&sendTypes[p]);
+    }
+    free(counts);
+    free(types);
+    return true;
+}
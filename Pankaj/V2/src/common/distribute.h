@@ -0,0 +1,29 @@
+#ifndef DISTRIBUTE_H
+#define DISTRIBUTE_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Root distribution without pack buffers: a rank's padded block is described by a
+// subarray type over the global [z][y][x][t] array and sent straight from globalData.
+
+// Committed subarray type selecting block's padded extents out of the global array
+MPI_Datatype createBlockType(const SubDomain* block, int nX, int nY, int nZ, int timeSteps,
+                             MPI_Datatype elementType);
+
+// The whole domain as the padded block of subdomain, so rank 0 can analyse its owned
+// cells inside globalData instead of a copy. Neighbour tests are unchanged: a ghost
+// cell is absent only where the global domain ends.
+SubDomain wholeDomainView(const SubDomain* subdomain, int nX, int nY, int nZ);
+
+// Whether rank 0's kernel can run on globalData directly (point-major, no transpose,
+// nothing uploaded to a device)
+bool rootAnalysesInPlace(const ProgramArgs* args);
+
+// Scatter every padded block of globalData (significant on rank 0 of comm only) with one
+// MPI_Alltoallw into localData, contiguous [z][y][x][t]. With rootInPlace rank 0 receives
+// nothing and localData may be NULL there. Collective over comm; false if out of memory.
+bool scatterBlocks(const void* globalData, void* localData, MPI_Datatype elementType,
+                   const SubDomain* subdomain, const ProgramArgs* args, bool rootInPlace, MPI_Comm comm);
+
+#endif // DISTRIBUTE_H
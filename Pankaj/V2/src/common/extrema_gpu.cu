@@ -0,0 +1,215 @@
+// CUDA/HIP extrema kernel for --device=gpu, built with make GPU=cuda (nvcc) or GPU=hip (hipcc).
+// One launch covers every timestep: threadIdx.x walks consecutive timesteps of a point, so
+// a warp reads a contiguous run of the point-major series, and threadIdx.y walks points.
+// Each block reduces its four per-timestep numbers in shared memory and folds them into the
+// global arrays with one set of atomics per timestep.
+
+#include <stdio.h>
+#include <math.h>
+#include "extrema_gpu.h"
+
+#if defined(__HIPCC__)
+#include <hip/hip_runtime.h>
+#define gpuError_t hipError_t
+#define gpuSuccess hipSuccess
+#define gpuGetErrorString hipGetErrorString
+#define gpuGetLastError hipGetLastError
+#define gpuGetDeviceCount hipGetDeviceCount
+#define gpuSetDevice hipSetDevice
+#define gpuMalloc hipMalloc
+#define gpuFree hipFree
+#define gpuMemcpy hipMemcpy
+#define gpuMemcpyHostToDevice hipMemcpyHostToDevice
+#define gpuMemcpyDeviceToHost hipMemcpyDeviceToHost
+#else
+#include <cuda_runtime.h>
+#define gpuError_t cudaError_t
+#define gpuSuccess cudaSuccess
+#define gpuGetErrorString cudaGetErrorString
+#define gpuGetLastError cudaGetLastError
+#define gpuGetDeviceCount cudaGetDeviceCount
+#define gpuSetDevice cudaSetDevice
+#define gpuMalloc cudaMalloc
+#define gpuFree cudaFree
+#define gpuMemcpy cudaMemcpy
+#define gpuMemcpyHostToDevice cudaMemcpyHostToDevice
+#define gpuMemcpyDeviceToHost cudaMemcpyDeviceToHost
+#endif
+
+// Threads per block; blockDim.x (timesteps) times blockDim.y (points)
+#define GPU_THREADS 256
+#define GPU_MAX_BLOCKS_X 4096
+
+// Print a failed GPU call and return 0 from the host function
+#define GPU_CHECK(call)                                                                    \
+    do {                                                                                   \
+        gpuError_t status = (call);                                                        \
+        if (status != gpuSuccess) {                                                        \
+            printf("Error: %s failed: %s\n", #call, gpuGetErrorString(status));            \
+            ok = 0;                                                                        \
+            goto done;                                                                     \
+        }                                                                                  \
+    } while (0)
+
+// Atomic min/max on doubles through compare-and-swap of their bits
+__device__ static void atomicMinDouble(double* address, double value) {
+    unsigned long long* bits = (unsigned long long*)address;
+    unsigned long long old = *bits;
+    while (value < __longlong_as_double((long long)old)) {
+        unsigned long long assumed = old;
+        old = atomicCAS(bits, assumed, (unsigned long long)__double_as_longlong(value));
+        if (old == assumed) break;
+    }
+}
+
+__device__ static void atomicMaxDouble(double* address, double value) {
+    unsigned long long* bits = (unsigned long long*)address;
+    unsigned long long old = *bits;
+    while (value > __longlong_as_double((long long)old)) {
+        unsigned long long assumed = old;
+        old = atomicCAS(bits, assumed, (unsigned long long)__double_as_longlong(value));
+        if (old == assumed) break;
+    }
+}
+
+template <typename Real>
+__global__ void extremaKernel(const Real* data, DeviceBlock block, int* minima, int* maxima,
+                              double* minValues, double* maxValues) {
+    extern __shared__ double shared[];
+    const int lanes = blockDim.x * blockDim.y;
+    double* sharedMin = shared;
+    double* sharedMax = shared + lanes;
+    int* sharedMinima = (int*)(shared + 2 * lanes);
+    int* sharedMaxima = sharedMinima + lanes;
+
+    const int t = blockIdx.y * blockDim.x + threadIdx.x;
+    const long nx = block.x1 - block.x0;
+    const long ny = block.y1 - block.y0;
+    const long points = nx * ny * (block.z1 - block.z0);
+    const long strideX = block.timeSteps;
+    const long strideY = strideX * block.width;
+    const long strideZ = strideY * block.height;
+
+    int minimaCount = 0;
+    int maximaCount = 0;
+    double minValue = HUGE_VAL;
+    double maxValue = -HUGE_VAL;
+
+    if (t < block.timeSteps) {
+        for (long i = (long)blockIdx.x * blockDim.y + threadIdx.y; i < points; i += (long)gridDim.x * blockDim.y) {
+            const int x = block.x0 + (int)(i % nx);
+            const int y = block.y0 + (int)((i / nx) % ny);
+            const int z = block.z0 + (int)(i / (nx * ny));
+            const Real* p = data + t + x * strideX + y * strideY + z * strideZ;
+            const Real value = *p;
+
+            if (value < minValue) minValue = value;
+            if (value > maxValue) maxValue = value;
+
+            // Same tests as classifyPoint: a missing neighbour never disqualifies
+            bool isMinimum = true;
+            bool isMaximum = true;
+            Real n;
+            if (x > 0) { n = p[-strideX]; isMinimum &= !(n <= value); isMaximum &= !(n >= value); }
+            if (x < block.width - 1) { n = p[strideX]; isMinimum &= !(n <= value); isMaximum &= !(n >= value); }
+            if (y > 0) { n = p[-strideY]; isMinimum &= !(n <= value); isMaximum &= !(n >= value); }
+            if (y < block.height - 1) { n = p[strideY]; isMinimum &= !(n <= value); isMaximum &= !(n >= value); }
+            if (z > 0) { n = p[-strideZ]; isMinimum &= !(n <= value); isMaximum &= !(n >= value); }
+            if (z < block.depth - 1) { n = p[strideZ]; isMinimum &= !(n <= value); isMaximum &= !(n >= value); }
+
+            minimaCount += isMinimum;
+            maximaCount += isMaximum;
+        }
+    }
+
+    // Tree reduction over the points of the block, one column per timestep
+    const int lane = threadIdx.y * blockDim.x + threadIdx.x;
+    sharedMin[lane] = minValue;
+    sharedMax[lane] = maxValue;
+    sharedMinima[lane] = minimaCount;
+    sharedMaxima[lane] = maximaCount;
+    __syncthreads();
+
+    for (int half = blockDim.y / 2; half > 0; half /= 2) {
+        if ((int)threadIdx.y < half) {
+            const int other = lane + half * blockDim.x;
+            if (sharedMin[other] < sharedMin[lane]) sharedMin[lane] = sharedMin[other];
+            if (sharedMax[other] > sharedMax[lane]) sharedMax[lane] = sharedMax[other];
+            sharedMinima[lane] += sharedMinima[other];
+            sharedMaxima[lane] += sharedMaxima[other];
+        }
+        __syncthreads();
+    }
+
+    if (threadIdx.y == 0 && t < block.timeSteps) {
+        atomicAdd(&minima[t], sharedMinima[lane]);
+        atomicAdd(&maxima[t], sharedMaxima[lane]);
+        atomicMinDouble(&minValues[t], sharedMin[lane]);
+        atomicMaxDouble(&maxValues[t], sharedMax[lane]);
+    }
+}
+
+extern "C" int gpuSelectDevice(int localRank) {
+    int count = 0;
+    if (gpuGetDeviceCount(&count) != gpuSuccess || count <= 0) return 0;
+    if (gpuSetDevice(localRank % count) != gpuSuccess) return 0;
+    return count;
+}
+
+extern "C" int gpuSweepBlock(const void* data, int elementSize, const DeviceBlock* block,
+                             int* minima, int* maxima, double* minValues, double* maxValues) {
+    const int timeSteps = block->timeSteps;
+    const size_t dataBytes = (size_t)block->width * block->height * block->depth * timeSteps * elementSize;
+    const long points = (long)(block->x1 - block->x0) * (block->y1 - block->y0) * (block->z1 - block->z0);
+
+    // Timesteps across x (a power of two up to 32), points across y
+    int lanesX = 1;
+    while (lanesX < timeSteps && lanesX < 32) lanesX *= 2;
+    const dim3 threads(lanesX, GPU_THREADS / lanesX);
+    long blocksX = (points + threads.y - 1) / threads.y;
+    if (blocksX > GPU_MAX_BLOCKS_X) blocksX = GPU_MAX_BLOCKS_X;
+    const dim3 blocks((unsigned)blocksX, (timeSteps + lanesX - 1) / lanesX);
+    const size_t sharedBytes = GPU_THREADS * (2 * sizeof(double) + 2 * sizeof(int));
+
+    void* deviceData = NULL;
+    int* deviceCounts = NULL;
+    double* deviceExtremes = NULL;
+    int ok = 1;
+
+    if (blocks.y > 65535) {
+        printf("Error: %d timesteps exceed one GPU launch\n", timeSteps);
+        return 0;
+    }
+
+    GPU_CHECK(gpuMalloc(&deviceData, dataBytes));
+    GPU_CHECK(gpuMalloc((void**)&deviceCounts, 2 * timeSteps * sizeof(int)));
+    GPU_CHECK(gpuMalloc((void**)&deviceExtremes, 2 * timeSteps * sizeof(double)));
+    GPU_CHECK(gpuMemcpy(deviceData, data, dataBytes, gpuMemcpyHostToDevice));
+    GPU_CHECK(gpuMemcpy(deviceCounts, minima, timeSteps * sizeof(int), gpuMemcpyHostToDevice));
+    GPU_CHECK(gpuMemcpy(deviceCounts + timeSteps, maxima, timeSteps * sizeof(int), gpuMemcpyHostToDevice));
+    GPU_CHECK(gpuMemcpy(deviceExtremes, minValues, timeSteps * sizeof(double), gpuMemcpyHostToDevice));
+    GPU_CHECK(gpuMemcpy(deviceExtremes + timeSteps, maxValues, timeSteps * sizeof(double), gpuMemcpyHostToDevice));
+
+    if (elementSize == sizeof(double)) {
+        extremaKernel<double><<<blocks, threads, sharedBytes>>>((const double*)deviceData, *block, deviceCounts,
+                                                                deviceCounts + timeSteps, deviceExtremes,
+                                                                deviceExtremes + timeSteps);
+    } else {
+        extremaKernel<float><<<blocks, threads, sharedBytes>>>((const float*)deviceData, *block, deviceCounts,
+                                                               deviceCounts + timeSteps, deviceExtremes,
+                                                               deviceExtremes + timeSteps);
+    }
+    GPU_CHECK(gpuGetLastError());
+
+    // The copies back wait for the kernel
+    GPU_CHECK(gpuMemcpy(minima, deviceCounts, timeSteps * sizeof(int), gpuMemcpyDeviceToHost));
+    GPU_CHECK(gpuMemcpy(maxima, deviceCounts + timeSteps, timeSteps * sizeof(int), gpuMemcpyDeviceToHost));
+    GPU_CHECK(gpuMemcpy(minValues, deviceExtremes, timeSteps * sizeof(double), gpuMemcpyDeviceToHost));
+    GPU_CHECK(gpuMemcpy(maxValues, deviceExtremes + timeSteps, timeSteps * sizeof(double), gpuMemcpyDeviceToHost));
+
+done:
+    gpuFree(deviceData);
+    gpuFree(deviceCounts);
+    gpuFree(deviceExtremes);
+    return ok;
+}
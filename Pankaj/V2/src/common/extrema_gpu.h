@@ -0,0 +1,32 @@
+#ifndef EXTREMA_GPU_H
+#define EXTREMA_GPU_H
+
+// C interface of the CUDA/HIP kernel (extrema_gpu.cu). Kept free of MPI and the
+// timeseries types so nvcc and hipcc need nothing but this header.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A padded point-major block and the half-open box of it to sweep, in padded-local points
+typedef struct {
+    int width, height, depth;
+    int timeSteps;
+    int x0, x1;
+    int y0, y1;
+    int z0, z1;
+} DeviceBlock;
+
+// Bind the calling process to GPU localRank % count; returns count (0: no usable GPU)
+int gpuSelectDevice(int localRank);
+
+// Copy data (elementSize 4 or 8) to the GPU, sweep the box and accumulate into the
+// timeSteps-long arrays (counts added, extremes folded in). 0 on any GPU error.
+int gpuSweepBlock(const void* data, int elementSize, const DeviceBlock* block,
+                  int* minima, int* maxima, double* minValues, double* maxValues);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EXTREMA_GPU_H
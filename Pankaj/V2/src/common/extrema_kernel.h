@@ -0,0 +1,460 @@
+// Extrema kernel bodies, instantiated once per element type by timeseries.c.
+// The includer defines KERNEL_REAL (element type) and KERNEL_NAME(base) (symbol name),
+// and KERNEL_HAS_SIMD when processBoxSimd exists for that type.
+// No include guard on purpose.
+
+// Outcomes of classifyPoint; a point without neighbours is both
+#define POINT_MINIMUM 1
+#define POINT_MAXIMUM 2
+
+// Joint min/max test of the point at p against the neighbours at p[offsets[n]] whose bit n
+// is set in neighbours, x first as the nearest in memory: the centre is loaded once and
+// both outcomes are decided in one pass. A point is a local minimum (maximum) when every
+// existing neighbour is strictly greater (smaller); ties disqualify.
+// With earlyExit the scan stops after the x, y or z pair once both outcomes are ruled
+// out. That pays on smooth fields, where the x pair rejects nearly every point, but on
+// noise the exits are unpredictable and the branch-free scan is about twice as fast.
+static inline int KERNEL_NAME(classifyPoint)(const KERNEL_REAL* p, const long offsets[6], unsigned neighbours,
+                                             bool earlyExit) {
+    const KERNEL_REAL value = *p;
+    bool isMinimum = true;
+    bool isMaximum = true;
+
+    for (int n = 0; n < 6; n++) {
+        if (neighbours & (1u << n)) {
+            const KERNEL_REAL neighbour = p[offsets[n]];
+            isMinimum &= !(neighbour <= value);
+            isMaximum &= !(neighbour >= value);
+        }
+        if (earlyExit && (n & 1) && n < 5 && !isMinimum && !isMaximum) return 0;
+    }
+    return (isMinimum ? POINT_MINIMUM : 0) | (isMaximum ? POINT_MAXIMUM : 0);
+}
+
+// Sweep one box of one timestep. Element (x, y, z) of that timestep lives at
+// origin[x * strideX + y * strideY + z * strideZ], which covers both the point-major
+// and the time-major layout; inlining lets the compiler specialise on the strides and
+// on earlyExit.
+static inline void KERNEL_NAME(sweepBox)(const KERNEL_REAL* origin, const SubDomain* subdomain,
+                                         const LocalBox* box, long strideX, long strideY, long strideZ,
+                                         TimeSeriesResults* results, int t, bool earlyExit) {
+    const int width = subdomain->tempWidth;
+    const int height = subdomain->tempHeight;
+    const int depth = subdomain->tempDepth;
+    const long offsets[6] = {-strideX, strideX, -strideY, strideY, -strideZ, strideZ};
+
+    int minimaCount = 0;
+    int maximaCount = 0;
+    double minValue = results->minValues[t];
+    double maxValue = results->maxValues[t];
+
+    for (int z = box->z0; z < box->z1; z++) {
+        // Existing neighbours as classifyPoint bits: x (0, 1), y (2, 3), z (4, 5)
+        const unsigned planeNeighbours = (z > 0 ? 16u : 0u) | (z < depth - 1 ? 32u : 0u);
+
+        for (int y = box->y0; y < box->y1; y++) {
+            const unsigned rowNeighbours = planeNeighbours | (y > 0 ? 4u : 0u) | (y < height - 1 ? 8u : 0u);
+            const KERNEL_REAL* p = origin + box->x0 * strideX + y * strideY + z * strideZ;
+
+            for (int x = box->x0; x < box->x1; x++, p += strideX) {
+                const KERNEL_REAL value = *p;
+
+                // Update min/max values
+                if (value < minValue) minValue = value;
+                if (value > maxValue) maxValue = value;
+
+                const unsigned neighbours = rowNeighbours | (x > 0 ? 1u : 0u) | (x < width - 1 ? 2u : 0u);
+                const int kind = KERNEL_NAME(classifyPoint)(p, offsets, neighbours, earlyExit);
+                minimaCount += kind & POINT_MINIMUM;
+                maximaCount += kind >> 1;
+            }
+        }
+    }
+
+    results->minimaCount[t] += minimaCount;
+    results->maximaCount[t] += maximaCount;
+    results->minValues[t] = minValue;
+    results->maxValues[t] = maxValue;
+}
+
+static inline void KERNEL_NAME(sweepPointMajor)(const KERNEL_REAL* localData, const SubDomain* subdomain,
+                                                const LocalBox* box, TimeSeriesResults* results, int timeSteps,
+                                                bool earlyExit) {
+    // Neighbouring points are a whole time series apart
+    const long strideX = timeSteps;
+    const long strideY = strideX * subdomain->tempWidth;
+    const long strideZ = strideY * subdomain->tempHeight;
+
+    for (int t = 0; t < timeSteps; t++) {
+        KERNEL_NAME(sweepBox)(localData + t, subdomain, box, strideX, strideY, strideZ, results, t, earlyExit);
+    }
+}
+
+static inline void KERNEL_NAME(sweepTimeMajor)(const KERNEL_REAL* localData, const SubDomain* subdomain,
+                                               const LocalBox* box, TimeSeriesResults* results, int timeSteps,
+                                               bool earlyExit) {
+    // Each timestep is a contiguous [z][y][x] volume, so x-rows are unit stride
+    const long strideY = subdomain->tempWidth;
+    const long strideZ = strideY * subdomain->tempHeight;
+    const long volume = strideZ * subdomain->tempDepth;
+
+    for (int t = 0; t < timeSteps; t++) {
+        KERNEL_NAME(sweepBox)(localData + t * volume, subdomain, box, 1, strideY, strideZ, results, t, earlyExit);
+    }
+}
+
+void KERNEL_NAME(processBox)(const KERNEL_REAL* localData, const SubDomain* subdomain, const LocalBox* box,
+                             TimeSeriesResults* results, int timeSteps) {
+    KERNEL_NAME(sweepPointMajor)(localData, subdomain, box, results, timeSteps, false);
+}
+
+void KERNEL_NAME(processBoxTimeMajor)(const KERNEL_REAL* localData, const SubDomain* subdomain, const LocalBox* box,
+                                      TimeSeriesResults* results, int timeSteps) {
+    KERNEL_NAME(sweepTimeMajor)(localData, subdomain, box, results, timeSteps, false);
+}
+
+void KERNEL_NAME(processBoxEarly)(const KERNEL_REAL* localData, const SubDomain* subdomain, const LocalBox* box,
+                                  TimeSeriesResults* results, int timeSteps) {
+    KERNEL_NAME(sweepPointMajor)(localData, subdomain, box, results, timeSteps, true);
+}
+
+void KERNEL_NAME(processBoxTimeMajorEarly)(const KERNEL_REAL* localData, const SubDomain* subdomain,
+                                           const LocalBox* box, TimeSeriesResults* results, int timeSteps) {
+    KERNEL_NAME(sweepTimeMajor)(localData, subdomain, box, results, timeSteps, true);
+}
+
+void KERNEL_NAME(processLocalData)(KERNEL_REAL* localData, const SubDomain* subdomain,
+                                   TimeSeriesResults* results, int timeSteps) {
+    LocalBox owned = ownedBox(subdomain);
+    KERNEL_NAME(processBox)(localData, subdomain, &owned, results, timeSteps);
+}
+
+void KERNEL_NAME(processLocalDataEarly)(KERNEL_REAL* localData, const SubDomain* subdomain,
+                                        TimeSeriesResults* results, int timeSteps) {
+    LocalBox owned = ownedBox(subdomain);
+    KERNEL_NAME(processBoxEarly)(localData, subdomain, &owned, results, timeSteps);
+}
+
+void KERNEL_NAME(processLocalDataTimeMajor)(KERNEL_REAL* localData, const SubDomain* subdomain,
+                                            TimeSeriesResults* results, int timeSteps) {
+    LocalBox owned = ownedBox(subdomain);
+    KERNEL_NAME(processBoxTimeMajor)(localData, subdomain, &owned, results, timeSteps);
+}
+
+// Point-major sweep that fills results and the extended statistics together: every owned
+// voxel is counted against the thresholds and histogram, every extremum is offered to the
+// top-k heaps under its global timestep (stepOffset + t) and coordinates
+static void KERNEL_NAME(processBoxStats)(const KERNEL_REAL* localData, const SubDomain* subdomain,
+                                         const LocalBox* box, TimeSeriesResults* results, ExtendedStats* stats,
+                                         int timeSteps, int stepOffset) {
+    const int width = subdomain->tempWidth;
+    const int height = subdomain->tempHeight;
+    const int depth = subdomain->tempDepth;
+    const long strideX = timeSteps;
+    const long strideY = strideX * width;
+    const long strideZ = strideY * height;
+    const long offsets[6] = {-strideX, strideX, -strideY, strideY, -strideZ, strideZ};
+
+    for (int t = 0; t < timeSteps; t++) {
+        const int step = stepOffset + t;
+        int minimaCount = 0;
+        int maximaCount = 0;
+        double minValue = results->minValues[t];
+        double maxValue = results->maxValues[t];
+
+        for (int z = box->z0; z < box->z1; z++) {
+            const unsigned planeNeighbours = (z > 0 ? 16u : 0u) | (z < depth - 1 ? 32u : 0u);
+
+            for (int y = box->y0; y < box->y1; y++) {
+                const unsigned rowNeighbours = planeNeighbours | (y > 0 ? 4u : 0u) | (y < height - 1 ? 8u : 0u);
+                const KERNEL_REAL* p = localData + t + box->x0 * strideX + y * strideY + z * strideZ;
+
+                for (int x = box->x0; x < box->x1; x++, p += strideX) {
+                    const KERNEL_REAL value = *p;
+                    if (value < minValue) minValue = value;
+                    if (value > maxValue) maxValue = value;
+                    statsAddValue(stats, step, value);
+
+                    const unsigned neighbours = rowNeighbours | (x > 0 ? 1u : 0u) | (x < width - 1 ? 2u : 0u);
+                    const int kind = KERNEL_NAME(classifyPoint)(p, offsets, neighbours, false);
+                    if (kind & POINT_MINIMUM) {
+                        minimaCount++;
+                        statsOfferMinimum(stats, step, value, subdomain->tempStartX + x,
+                                          subdomain->tempStartY + y, subdomain->tempStartZ + z);
+                    }
+                    if (kind & POINT_MAXIMUM) {
+                        maximaCount++;
+                        statsOfferMaximum(stats, step, value, subdomain->tempStartX + x,
+                                          subdomain->tempStartY + y, subdomain->tempStartZ + z);
+                    }
+                }
+            }
+        }
+
+        results->minimaCount[t] += minimaCount;
+        results->maximaCount[t] += maximaCount;
+        results->minValues[t] = minValue;
+        results->maxValues[t] = maxValue;
+    }
+}
+
+// Interior of a point-major block, all timesteps per visit. Every neighbour exists, so the
+// tests are branch-free; written as !(n <= v) so NaN behaves like classifyPoint.
+static void KERNEL_NAME(sweepInteriorFused)(const KERNEL_REAL* localData, const SubDomain* subdomain,
+                                            const LocalBox* box, int timeSteps,
+                                            int* restrict minima, int* restrict maxima,
+                                            KERNEL_REAL* restrict minValues, KERNEL_REAL* restrict maxValues) {
+    const long strideX = timeSteps;
+    const long strideY = strideX * subdomain->tempWidth;
+    const long strideZ = strideY * subdomain->tempHeight;
+
+    for (int z = box->z0; z < box->z1; z++) {
+        for (int y = box->y0; y < box->y1; y++) {
+            const KERNEL_REAL* restrict p = localData + box->x0 * strideX + y * strideY + z * strideZ;
+
+            for (int x = box->x0; x < box->x1; x++, p += strideX) {
+                // The whole series of the point and of each neighbour is contiguous
+                for (int t = 0; t < timeSteps; t++) {
+                    const KERNEL_REAL value = p[t];
+                    const KERNEL_REAL left = p[t - strideX], right = p[t + strideX];
+                    const KERNEL_REAL front = p[t - strideY], back = p[t + strideY];
+                    const KERNEL_REAL below = p[t - strideZ], above = p[t + strideZ];
+
+                    if (value < minValues[t]) minValues[t] = value;
+                    if (value > maxValues[t]) maxValues[t] = value;
+
+                    minima[t] += !(left <= value) & !(right <= value) & !(front <= value) &
+                                 !(back <= value) & !(below <= value) & !(above <= value);
+                    maxima[t] += !(left >= value) & !(right >= value) & !(front >= value) &
+                                 !(back >= value) & !(below >= value) & !(above >= value);
+                }
+            }
+        }
+    }
+}
+
+void KERNEL_NAME(processBoxFused)(const KERNEL_REAL* localData, const SubDomain* subdomain, const LocalBox* box,
+                                  TimeSeriesResults* results, int timeSteps) {
+    LocalBox interior = intersectBox(*box, interiorBox(subdomain));
+
+    // Per-timestep accumulators private to this call so the t loop carries no aliasing
+    int* minima = (int*)calloc(2 * timeSteps, sizeof(int));
+    KERNEL_REAL* extremes = (KERNEL_REAL*)malloc(2 * timeSteps * sizeof(KERNEL_REAL));
+    if (!minima || !extremes) {
+        free(minima);
+        free(extremes);
+        KERNEL_NAME(processBox)(localData, subdomain, box, results, timeSteps);
+        return;
+    }
+    int* maxima = minima + timeSteps;
+    KERNEL_REAL* minValues = extremes;
+    KERNEL_REAL* maxValues = extremes + timeSteps;
+
+    for (int t = 0; t < timeSteps; t++) {
+        minValues[t] = INFINITY;
+        maxValues[t] = -INFINITY;
+    }
+
+    if (!isEmptyBox(&interior)) {
+        KERNEL_NAME(sweepInteriorFused)(localData, subdomain, &interior, timeSteps,
+                                        minima, maxima, minValues, maxValues);
+    }
+
+    for (int t = 0; t < timeSteps; t++) {
+        results->minimaCount[t] += minima[t];
+        results->maximaCount[t] += maxima[t];
+        if (minValues[t] < results->minValues[t]) results->minValues[t] = minValues[t];
+        if (maxValues[t] > results->maxValues[t]) results->maxValues[t] = maxValues[t];
+    }
+
+    free(minima);
+    free(extremes);
+
+    // Points on the global boundary keep the existence checks
+    LocalBox shell[6];
+    int shellCount = splitShell(box, &interior, shell);
+    for (int i = 0; i < shellCount; i++) {
+        KERNEL_NAME(processBox)(localData, subdomain, &shell[i], results, timeSteps);
+    }
+}
+
+void KERNEL_NAME(processLocalDataFused)(KERNEL_REAL* localData, const SubDomain* subdomain,
+                                        TimeSeriesResults* results, int timeSteps) {
+    LocalBox owned = ownedBox(subdomain);
+    KERNEL_NAME(processBoxFused)(localData, subdomain, &owned, results, timeSteps);
+}
+
+KERNEL_REAL* KERNEL_NAME(transposeToTimeMajor)(const KERNEL_REAL* localData, const SubDomain* subdomain,
+                                               int timeSteps) {
+    const long rowLength = subdomain->tempWidth;
+    const long rows = (long)subdomain->tempHeight * subdomain->tempDepth;
+    const long volume = rowLength * rows;
+
+    KERNEL_REAL* transposed = (KERNEL_REAL*)malloc(volume * timeSteps * sizeof(KERNEL_REAL));
+    if (!transposed) {
+        printf("Failed to allocate memory for time-major data\n");
+        return NULL;
+    }
+
+    // One padded x-row at a time: the source row is contiguous and every
+    // timestep writes its own contiguous destination row
+    for (long row = 0; row < rows; row++) {
+        const KERNEL_REAL* src = localData + row * rowLength * timeSteps;
+        for (int t = 0; t < timeSteps; t++) {
+            KERNEL_REAL* dst = transposed + t * volume + row * rowLength;
+            for (long x = 0; x < rowLength; x++) {
+                dst[x] = src[x * timeSteps + t];
+            }
+        }
+    }
+
+    return transposed;
+}
+
+// Run the kernel selected on the command line over one box of the prepared block; with
+// stats the statistics sweep (point-major data only) runs instead
+static void KERNEL_NAME(analyzeBox)(const KERNEL_REAL* data, bool timeMajor, const SubDomain* subdomain,
+                                    const LocalBox* box, TimeSeriesResults* results, ExtendedStats* stats,
+                                    const ProgramArgs* args) {
+    if (stats) {
+        KERNEL_NAME(processBoxStats)(data, subdomain, box, results, stats, args->timeSteps, args->stepOffset);
+    } else if (timeMajor) {
+#ifdef KERNEL_HAS_SIMD
+        if (args->kernel == KERNEL_SIMD) {
+            processBoxSimd(data, subdomain, box, results, args->timeSteps);
+            return;
+        }
+#endif
+        if (args->kernel == KERNEL_EARLY) {
+            KERNEL_NAME(processBoxTimeMajorEarly)(data, subdomain, box, results, args->timeSteps);
+            return;
+        }
+        KERNEL_NAME(processBoxTimeMajor)(data, subdomain, box, results, args->timeSteps);
+    } else if (args->kernel == KERNEL_EARLY) {
+        KERNEL_NAME(processBoxEarly)(data, subdomain, box, results, args->timeSteps);
+    } else if (args->kernel != KERNEL_SCALAR) {
+        // simd on point-major data (no time-major copy) uses the fused sweep
+        KERNEL_NAME(processBoxFused)(data, subdomain, box, results, args->timeSteps);
+    } else {
+        KERNEL_NAME(processBox)(data, subdomain, box, results, args->timeSteps);
+    }
+}
+
+#ifdef _OPENMP
+// Threaded sweep: tiles of the owned box are shared out, every thread accumulates into
+// its own results (and statistics) and the partial results are merged in thread order
+// afterwards. Returns false (nothing done) if the per-thread buffers cannot be allocated.
+static bool KERNEL_NAME(analyzeThreaded)(const KERNEL_REAL* data, bool timeMajor, const SubDomain* subdomain,
+                                         const LocalBox* owned, TimeSeriesResults* results, ExtendedStats* stats,
+                                         const ProgramArgs* args, int threads) {
+    const int tileCount = splitTiles(owned, threads, NULL);
+    LocalBox* tiles = (LocalBox*)malloc((tileCount > 0 ? tileCount : 1) * sizeof(LocalBox));
+    TimeSeriesResults** partial = (TimeSeriesResults**)calloc(threads, sizeof(TimeSeriesResults*));
+    ExtendedStats** partialStats = (ExtendedStats**)calloc(threads, sizeof(ExtendedStats*));
+    bool ok = tiles && partial && partialStats;
+    for (int i = 0; ok && i < threads; i++) {
+        partial[i] = allocateResults(args->timeSteps);
+        if (stats) partialStats[i] = statsCreate(args, stats->timeSteps);
+        ok = partial[i] != NULL && (!stats || partialStats[i] != NULL);
+    }
+
+    if (ok) {
+        splitTiles(owned, threads, tiles);
+
+        #pragma omp parallel num_threads(threads)
+        {
+            TimeSeriesResults* mine = partial[omp_get_thread_num()];
+            ExtendedStats* myStats = partialStats[omp_get_thread_num()];
+
+            #pragma omp for schedule(static)
+            for (int i = 0; i < tileCount; i++) {
+                KERNEL_NAME(analyzeBox)(data, timeMajor, subdomain, &tiles[i], mine, myStats, args);
+            }
+        }
+
+        for (int i = 0; i < threads; i++) {
+            mergeResults(results, partial[i], args->timeSteps);
+            if (stats) statsMerge(stats, partialStats[i]);
+        }
+    }
+
+    for (int i = 0; partial && i < threads; i++) {
+        if (partial[i]) freeResults(partial[i]);
+        if (partialStats) statsFree(partialStats[i]);
+    }
+    free(partialStats);
+    free(partial);
+    free(tiles);
+    return ok;
+}
+#endif
+
+// Sweep box of a prepared block, threaded in OpenMP builds
+static void KERNEL_NAME(analyzeBlock)(const KERNEL_REAL* data, bool timeMajor, const SubDomain* subdomain,
+                                      const LocalBox* box, TimeSeriesResults* results, ExtendedStats* stats,
+                                      const ProgramArgs* args) {
+    bool done = false;
+
+#ifdef _OPENMP
+    const int threads = args->threads > 0 ? args->threads : omp_get_max_threads();
+    if (threads > 1) {
+        done = KERNEL_NAME(analyzeThreaded)(data, timeMajor, subdomain, box, results, stats, args, threads);
+    }
+#endif
+
+    if (!done) {
+        KERNEL_NAME(analyzeBox)(data, timeMajor, subdomain, box, results, stats, args);
+    }
+}
+
+void KERNEL_NAME(analyzeLocalData)(KERNEL_REAL* localData, const SubDomain* subdomain,
+                                   TimeSeriesResults* results, const ProgramArgs* args) {
+    // simd implies the time-major layout; if the second copy cannot be allocated the
+    // point-major block is analysed instead
+    const double blockBytes = (double)subdomain->tempWidth * subdomain->tempHeight * subdomain->tempDepth *
+                              args->timeSteps * sizeof(KERNEL_REAL);
+    LocalBox owned = ownedBox(subdomain);
+
+    // Extended statistics come from one point-major host sweep that also fills results
+    ExtendedStats* stats = statsFor(args);
+    if (stats) {
+        profileBegin(PROFILE_COMPUTE);
+        KERNEL_NAME(analyzeBlock)(localData, false, subdomain, &owned, results, stats, args);
+        profileEnd(PROFILE_COMPUTE, blockBytes);
+        return;
+    }
+
+    // On an accelerator the block is copied over as it is; the host kernels run if that fails
+    if (args->device != DEVICE_CPU) {
+        profileBegin(PROFILE_COMPUTE);
+        bool offloaded = deviceAnalyzeBox(localData, sizeof(KERNEL_REAL) == sizeof(double), subdomain, &owned,
+                                          results, args->timeSteps, args->device);
+        profileEnd(PROFILE_COMPUTE, offloaded ? blockBytes : 0);
+        if (offloaded) return;
+    }
+
+    KERNEL_REAL* transposed = NULL;
+    if (args->layout == LAYOUT_TIME_MAJOR || args->kernel == KERNEL_SIMD) {
+        profileBegin(PROFILE_PACK);
+        transposed = KERNEL_NAME(transposeToTimeMajor)(localData, subdomain, args->timeSteps);
+        profileEnd(PROFILE_PACK, transposed ? 2 * blockBytes : 0);
+    }
+    const KERNEL_REAL* data = transposed ? transposed : localData;
+
+    profileBegin(PROFILE_COMPUTE);
+    KERNEL_NAME(analyzeBlock)(data, transposed != NULL, subdomain, &owned, results, NULL, args);
+    profileEnd(PROFILE_COMPUTE, blockBytes);
+
+    free(transposed);
+}
+
+void KERNEL_NAME(analyzeLocalBox)(const KERNEL_REAL* localData, const SubDomain* subdomain, const LocalBox* box,
+                                  TimeSeriesResults* results, const ProgramArgs* args) {
+    profileBegin(PROFILE_COMPUTE);
+    KERNEL_NAME(analyzeBlock)(localData, false, subdomain, box, results, statsFor(args), args);
+    profileEnd(PROFILE_COMPUTE, isEmptyBox(box) ? 0 : (double)(box->x1 - box->x0) * (box->y1 - box->y0) *
+                                (box->z1 - box->z0) * args->timeSteps * sizeof(KERNEL_REAL));
+}
+
+#undef POINT_MINIMUM
+#undef POINT_MAXIMUM
@@ -0,0 +1,58 @@
+// OpenMP target sweep, instantiated once per element type by device.c.
+// The includer defines KERNEL_REAL (element type) and KERNEL_NAME(base) (symbol name).
+// No include guard on purpose.
+
+// The block is mapped once; every timestep is one target region over the box whose
+// reductions leave only four numbers on the device. Same tests as classifyPoint.
+static void KERNEL_NAME(offloadSweep)(const KERNEL_REAL* data, const DeviceBlock* block, int* minima, int* maxima,
+                                      double* minValues, double* maxValues) {
+    const int width = block->width, height = block->height, depth = block->depth;
+    const int timeSteps = block->timeSteps;
+    const int x0 = block->x0, x1 = block->x1, y0 = block->y0, y1 = block->y1, z0 = block->z0, z1 = block->z1;
+    const long strideX = timeSteps;
+    const long strideY = strideX * width;
+    const long strideZ = strideY * height;
+    const long count = strideZ * depth;
+
+    #pragma omp target data map(to: data[0:count])
+    for (int t = 0; t < timeSteps; t++) {
+        int minimaCount = 0;
+        int maximaCount = 0;
+        double minValue = minValues[t];
+        double maxValue = maxValues[t];
+
+        #pragma omp target teams distribute parallel for collapse(3) \
+            map(tofrom: minimaCount, maximaCount, minValue, maxValue) \
+            reduction(+: minimaCount, maximaCount) reduction(min: minValue) reduction(max: maxValue)
+        for (int z = z0; z < z1; z++) {
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    const KERNEL_REAL* p = data + t + x * strideX + y * strideY + z * strideZ;
+                    const KERNEL_REAL value = *p;
+
+                    if (value < minValue) minValue = value;
+                    if (value > maxValue) maxValue = value;
+
+                    bool isMinimum = true;
+                    bool isMaximum = true;
+                    const long offsets[6] = {-strideX, strideX, -strideY, strideY, -strideZ, strideZ};
+                    const bool exists[6] = {x > 0, x < width - 1, y > 0, y < height - 1, z > 0, z < depth - 1};
+                    for (int n = 0; n < 6; n++) {
+                        if (!exists[n]) continue;
+                        const KERNEL_REAL neighbour = p[offsets[n]];
+                        if (neighbour <= value) isMinimum = false;
+                        if (neighbour >= value) isMaximum = false;
+                    }
+
+                    minimaCount += isMinimum;
+                    maximaCount += isMaximum;
+                }
+            }
+        }
+
+        minima[t] += minimaCount;
+        maxima[t] += maximaCount;
+        minValues[t] = minValue;
+        maxValues[t] = maxValue;
+    }
+}
@@ -0,0 +1,196 @@
+#include <math.h>
+#include "timeseries.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+
+// Per-timestep accumulator for one sweep of the interior
+typedef struct {
+    int minimaCount;
+    int maximaCount;
+    float minValue;
+    float maxValue;
+} RowTotals;
+
+// Scalar classification of row[x0..x1); every neighbour is known to exist.
+// The comparisons are written so NaN behaves exactly like the scalar kernel:
+// a NaN neighbour never disqualifies and a NaN value is never counted.
+static void classifyRowScalar(const float* row, int x0, int x1, long strideY, long strideZ, RowTotals* totals) {
+    for (int x = x0; x < x1; x++) {
+        const float* p = row + x;
+        const float value = *p;
+
+        if (value < totals->minValue) totals->minValue = value;
+        if (value > totals->maxValue) totals->maxValue = value;
+
+        const bool isMinimum = !(p[-1] <= value) & !(p[1] <= value) &
+                               !(p[-strideY] <= value) & !(p[strideY] <= value) &
+                               !(p[-strideZ] <= value) & !(p[strideZ] <= value);
+        const bool isMaximum = !(p[-1] >= value) & !(p[1] >= value) &
+                               !(p[-strideY] >= value) & !(p[strideY] >= value) &
+                               !(p[-strideZ] >= value) & !(p[strideZ] >= value);
+
+        totals->minimaCount += isMinimum;
+        totals->maximaCount += isMaximum;
+    }
+}
+
+typedef void (*ClassifyRowFn)(const float* row, int x0, int x1, long strideY, long strideZ, RowTotals* totals);
+
+#ifdef HAVE_X86_SIMD
+
+// _CMP_NLE_UQ is "not (n <= v)", true for unordered operands, which is the scalar rule above
+__attribute__((target("avx2")))
+static void classifyRowAvx2(const float* row, int x0, int x1, long strideY, long strideZ, RowTotals* totals) {
+    __m256 minAcc = _mm256_set1_ps(totals->minValue);
+    __m256 maxAcc = _mm256_set1_ps(totals->maxValue);
+    int minimaCount = 0;
+    int maximaCount = 0;
+
+    int x = x0;
+    for (; x + 8 <= x1; x += 8) {
+        const float* p = row + x;
+        const __m256 v = _mm256_loadu_ps(p);
+        const __m256 n0 = _mm256_loadu_ps(p - 1);
+        const __m256 n1 = _mm256_loadu_ps(p + 1);
+        const __m256 n2 = _mm256_loadu_ps(p - strideY);
+        const __m256 n3 = _mm256_loadu_ps(p + strideY);
+        const __m256 n4 = _mm256_loadu_ps(p - strideZ);
+        const __m256 n5 = _mm256_loadu_ps(p + strideZ);
+
+        // min_ps(v, acc) returns acc when v is NaN, matching "if (value < minValue)"
+        minAcc = _mm256_min_ps(v, minAcc);
+        maxAcc = _mm256_max_ps(v, maxAcc);
+
+        __m256 isMin = _mm256_and_ps(_mm256_cmp_ps(n0, v, _CMP_NLE_UQ), _mm256_cmp_ps(n1, v, _CMP_NLE_UQ));
+        isMin = _mm256_and_ps(isMin, _mm256_and_ps(_mm256_cmp_ps(n2, v, _CMP_NLE_UQ), _mm256_cmp_ps(n3, v, _CMP_NLE_UQ)));
+        isMin = _mm256_and_ps(isMin, _mm256_and_ps(_mm256_cmp_ps(n4, v, _CMP_NLE_UQ), _mm256_cmp_ps(n5, v, _CMP_NLE_UQ)));
+
+        __m256 isMax = _mm256_and_ps(_mm256_cmp_ps(n0, v, _CMP_NGE_UQ), _mm256_cmp_ps(n1, v, _CMP_NGE_UQ));
+        isMax = _mm256_and_ps(isMax, _mm256_and_ps(_mm256_cmp_ps(n2, v, _CMP_NGE_UQ), _mm256_cmp_ps(n3, v, _CMP_NGE_UQ)));
+        isMax = _mm256_and_ps(isMax, _mm256_and_ps(_mm256_cmp_ps(n4, v, _CMP_NGE_UQ), _mm256_cmp_ps(n5, v, _CMP_NGE_UQ)));
+
+        minimaCount += __builtin_popcount(_mm256_movemask_ps(isMin));
+        maximaCount += __builtin_popcount(_mm256_movemask_ps(isMax));
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps(lanes, minAcc);
+    for (int i = 0; i < 8; i++) if (lanes[i] < totals->minValue) totals->minValue = lanes[i];
+    _mm256_storeu_ps(lanes, maxAcc);
+    for (int i = 0; i < 8; i++) if (lanes[i] > totals->maxValue) totals->maxValue = lanes[i];
+
+    totals->minimaCount += minimaCount;
+    totals->maximaCount += maximaCount;
+
+    // Row tail shorter than one vector
+    classifyRowScalar(row, x, x1, strideY, strideZ, totals);
+}
+
+__attribute__((target("avx512f")))
+static void classifyRowAvx512(const float* row, int x0, int x1, long strideY, long strideZ, RowTotals* totals) {
+    __m512 minAcc = _mm512_set1_ps(totals->minValue);
+    __m512 maxAcc = _mm512_set1_ps(totals->maxValue);
+    int minimaCount = 0;
+    int maximaCount = 0;
+
+    int x = x0;
+    for (; x + 16 <= x1; x += 16) {
+        const float* p = row + x;
+        const __m512 v = _mm512_loadu_ps(p);
+        const __m512 n0 = _mm512_loadu_ps(p - 1);
+        const __m512 n1 = _mm512_loadu_ps(p + 1);
+        const __m512 n2 = _mm512_loadu_ps(p - strideY);
+        const __m512 n3 = _mm512_loadu_ps(p + strideY);
+        const __m512 n4 = _mm512_loadu_ps(p - strideZ);
+        const __m512 n5 = _mm512_loadu_ps(p + strideZ);
+
+        minAcc = _mm512_min_ps(v, minAcc);
+        maxAcc = _mm512_max_ps(v, maxAcc);
+
+        // Masked compares chain the six tests without materialising vectors
+        __mmask16 isMin = _mm512_cmp_ps_mask(n0, v, _CMP_NLE_UQ);
+        isMin = _mm512_mask_cmp_ps_mask(isMin, n1, v, _CMP_NLE_UQ);
+        isMin = _mm512_mask_cmp_ps_mask(isMin, n2, v, _CMP_NLE_UQ);
+        isMin = _mm512_mask_cmp_ps_mask(isMin, n3, v, _CMP_NLE_UQ);
+        isMin = _mm512_mask_cmp_ps_mask(isMin, n4, v, _CMP_NLE_UQ);
+        isMin = _mm512_mask_cmp_ps_mask(isMin, n5, v, _CMP_NLE_UQ);
+
+        __mmask16 isMax = _mm512_cmp_ps_mask(n0, v, _CMP_NGE_UQ);
+        isMax = _mm512_mask_cmp_ps_mask(isMax, n1, v, _CMP_NGE_UQ);
+        isMax = _mm512_mask_cmp_ps_mask(isMax, n2, v, _CMP_NGE_UQ);
+        isMax = _mm512_mask_cmp_ps_mask(isMax, n3, v, _CMP_NGE_UQ);
+        isMax = _mm512_mask_cmp_ps_mask(isMax, n4, v, _CMP_NGE_UQ);
+        isMax = _mm512_mask_cmp_ps_mask(isMax, n5, v, _CMP_NGE_UQ);
+
+        minimaCount += __builtin_popcount((unsigned)isMin);
+        maximaCount += __builtin_popcount((unsigned)isMax);
+    }
+
+    float lanes[16];
+    _mm512_storeu_ps(lanes, minAcc);
+    for (int i = 0; i < 16; i++) if (lanes[i] < totals->minValue) totals->minValue = lanes[i];
+    _mm512_storeu_ps(lanes, maxAcc);
+    for (int i = 0; i < 16; i++) if (lanes[i] > totals->maxValue) totals->maxValue = lanes[i];
+
+    totals->minimaCount += minimaCount;
+    totals->maximaCount += maximaCount;
+
+    classifyRowScalar(row, x, x1, strideY, strideZ, totals);
+}
+
+#endif // HAVE_X86_SIMD
+
+// Widest row kernel the running CPU supports (cheap, safe to call from any thread)
+static ClassifyRowFn selectRowKernel(void) {
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return classifyRowAvx512;
+    if (__builtin_cpu_supports("avx2")) return classifyRowAvx2;
+#endif
+    return classifyRowScalar;
+}
+
+void processBoxSimd(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                    TimeSeriesResults* results, int timeSteps) {
+    const ClassifyRowFn classifyRow = selectRowKernel();
+
+    const long strideY = subdomain->tempWidth;
+    const long strideZ = strideY * subdomain->tempHeight;
+    const long volume = strideZ * subdomain->tempDepth;
+
+    // Interior: branch-free rows, no neighbour-existence tests
+    LocalBox interior = intersectBox(*box, interiorBox(subdomain));
+
+    if (!isEmptyBox(&interior)) {
+        for (int t = 0; t < timeSteps; t++) {
+            const float* base = localData + t * volume;
+            RowTotals totals = { 0, 0, INFINITY, -INFINITY };
+
+            for (int z = interior.z0; z < interior.z1; z++) {
+                for (int y = interior.y0; y < interior.y1; y++) {
+                    classifyRow(base + z * strideZ + y * strideY, interior.x0, interior.x1, strideY, strideZ, &totals);
+                }
+            }
+
+            results->minimaCount[t] += totals.minimaCount;
+            results->maximaCount[t] += totals.maximaCount;
+            if (totals.minValue < results->minValues[t]) results->minValues[t] = totals.minValue;
+            if (totals.maxValue > results->maxValues[t]) results->maxValues[t] = totals.maxValue;
+        }
+    }
+
+    // Faces on the global boundary keep the generic kernel with its existence checks
+    LocalBox shell[6];
+    int shellCount = splitShell(box, &interior, shell);
+    for (int i = 0; i < shellCount; i++) {
+        processBoxTimeMajor(localData, subdomain, &shell[i], results, timeSteps);
+    }
+}
+
+void processLocalDataSimd(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    LocalBox owned = ownedBox(subdomain);
+    processBoxSimd(localData, subdomain, &owned, results, timeSteps);
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "halo.h"
+#include "placement.h"
+
+// Subarray of the padded point-major block [tempDepth][tempHeight][tempWidth][timeSteps]
+static MPI_Datatype blockSubarray(const SubDomain* subdomain, int timeSteps, const LocalBox* box) {
+    int sizes[4] = {subdomain->tempDepth, subdomain->tempHeight, subdomain->tempWidth, timeSteps};
+    int subSizes[4] = {box->z1 - box->z0, box->y1 - box->y0, box->x1 - box->x0, timeSteps};
+    int starts[4] = {box->z0, box->y0, box->x0, 0};
+
+    MPI_Datatype type;
+    MPI_Type_create_subarray(4, sizes, subSizes, starts, MPI_ORDER_C, MPI_FLOAT, &type);
+    MPI_Type_commit(&type);
+    return type;
+}
+
+// Rank holding the grid neighbour step positions along Cartesian dimension dim of the
+// block at grid position index, MPI_PROC_NULL past the edge of the grid
+static int neighbourRank(MPI_Comm cart, int index, int dim, int step) {
+    int dims[3], periods[3], coords[3];
+    MPI_Cart_get(cart, 3, dims, periods, coords);
+    MPI_Cart_coords(cart, index, 3, coords);
+    coords[dim] += step;
+    if (coords[dim] < 0 || coords[dim] >= dims[dim]) return MPI_PROC_NULL;
+
+    int neighbour;
+    MPI_Cart_rank(cart, coords, &neighbour);
+    return placementRankAt(neighbour);
+}
+
+bool haloCreate(HaloExchange* halo, const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm) {
+    // Slowest dimension first so Cartesian coordinates of grid position (z * pY + y) * pX + x
+    // are (z, y, x); ranks are not reordered, the grid order comes from placement.h
+    int dims[3] = {args->pZ, args->pY, args->pX};
+    int periods[3] = {0, 0, 0};
+
+    int ret = MPI_Cart_create(comm, 3, dims, periods, 0, &halo->cart);
+    if (ret != MPI_SUCCESS || halo->cart == MPI_COMM_NULL) {
+        printf("Failed to create Cartesian communicator\n");
+        return false;
+    }
+
+    int rank;
+    MPI_Comm_rank(halo->cart, &rank);
+    const int index = placementGridIndex(rank);
+    halo->neighbours[FACE_LOW_X] = neighbourRank(halo->cart, index, 2, -1);
+    halo->neighbours[FACE_HIGH_X] = neighbourRank(halo->cart, index, 2, 1);
+    halo->neighbours[FACE_LOW_Y] = neighbourRank(halo->cart, index, 1, -1);
+    halo->neighbours[FACE_HIGH_Y] = neighbourRank(halo->cart, index, 1, 1);
+    halo->neighbours[FACE_LOW_Z] = neighbourRank(halo->cart, index, 0, -1);
+    halo->neighbours[FACE_HIGH_Z] = neighbourRank(halo->cart, index, 0, 1);
+
+    const LocalBox owned = ownedBox(subdomain);
+
+    for (int face = 0; face < FACE_COUNT; face++) {
+        halo->sendType[face] = MPI_DATATYPE_NULL;
+        halo->recvType[face] = MPI_DATATYPE_NULL;
+        if (halo->neighbours[face] == MPI_PROC_NULL) continue;
+
+        // Owned plane on this side, and the ghost plane just outside it
+        LocalBox send = owned;
+        LocalBox recv = owned;
+        switch (face) {
+            case FACE_LOW_X:  send.x1 = owned.x0 + 1; recv.x0 = owned.x0 - 1; recv.x1 = owned.x0; break;
+            case FACE_HIGH_X: send.x0 = owned.x1 - 1; recv.x0 = owned.x1; recv.x1 = owned.x1 + 1; break;
+            case FACE_LOW_Y:  send.y1 = owned.y0 + 1; recv.y0 = owned.y0 - 1; recv.y1 = owned.y0; break;
+            case FACE_HIGH_Y: send.y0 = owned.y1 - 1; recv.y0 = owned.y1; recv.y1 = owned.y1 + 1; break;
+            case FACE_LOW_Z:  send.z1 = owned.z0 + 1; recv.z0 = owned.z0 - 1; recv.z1 = owned.z0; break;
+            case FACE_HIGH_Z: send.z0 = owned.z1 - 1; recv.z0 = owned.z1; recv.z1 = owned.z1 + 1; break;
+        }
+
+        halo->sendType[face] = blockSubarray(subdomain, args->timeSteps, &send);
+        halo->recvType[face] = blockSubarray(subdomain, args->timeSteps, &recv);
+    }
+
+    halo->requestCount = 0;
+    return true;
+}
+
+void haloStart(HaloExchange* halo, float* localData) {
+    halo->requestCount = 0;
+
+    // A message is tagged with the face it leaves through, so the receiver expects
+    // the opposite face of its own (FACE_LOW_X <-> FACE_HIGH_X, ...)
+    for (int face = 0; face < FACE_COUNT; face++) {
+        if (halo->neighbours[face] == MPI_PROC_NULL) continue;
+        MPI_Irecv(localData, 1, halo->recvType[face], halo->neighbours[face], face ^ 1,
+                  halo->cart, &halo->requests[halo->requestCount++]);
+    }
+
+    for (int face = 0; face < FACE_COUNT; face++) {
+        if (halo->neighbours[face] == MPI_PROC_NULL) continue;
+        MPI_Isend(localData, 1, halo->sendType[face], halo->neighbours[face], face,
+                  halo->cart, &halo->requests[halo->requestCount++]);
+    }
+}
+
+void haloFinish(HaloExchange* halo) {
+    MPI_Waitall(halo->requestCount, halo->requests, MPI_STATUSES_IGNORE);
+    halo->requestCount = 0;
+}
+
+void haloFree(HaloExchange* halo) {
+    for (int face = 0; face < FACE_COUNT; face++) {
+        if (halo->sendType[face] != MPI_DATATYPE_NULL) MPI_Type_free(&halo->sendType[face]);
+        if (halo->recvType[face] != MPI_DATATYPE_NULL) MPI_Type_free(&halo->recvType[face]);
+    }
+    MPI_Comm_free(&halo->cart);
+}
+
+LocalBox haloIndependentBox(const HaloExchange* halo, const SubDomain* subdomain) {
+    LocalBox box = ownedBox(subdomain);
+    if (halo->neighbours[FACE_LOW_X] != MPI_PROC_NULL) box.x0++;
+    if (halo->neighbours[FACE_HIGH_X] != MPI_PROC_NULL) box.x1--;
+    if (halo->neighbours[FACE_LOW_Y] != MPI_PROC_NULL) box.y0++;
+    if (halo->neighbours[FACE_HIGH_Y] != MPI_PROC_NULL) box.y1--;
+    if (halo->neighbours[FACE_LOW_Z] != MPI_PROC_NULL) box.z0++;
+    if (halo->neighbours[FACE_HIGH_Z] != MPI_PROC_NULL) box.z1--;
+    return box;
+}
+
+float* readOwnedCells(const char* inputFile, const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm) {
+    const int timeSteps = args->timeSteps;
+    long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                         subdomain->tempDepth * timeSteps;
+
+    float* localData = (float*)allocateLocalBlock(subdomain, localDataSize * sizeof(float));
+    if (!localData) {
+        printf("Failed to allocate memory for local data\n");
+        return NULL;
+    }
+
+    MPI_File fh;
+    int ret = MPI_File_open(comm, inputFile, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+    if (ret != MPI_SUCCESS) {
+        char error_string[MPI_MAX_ERROR_STRING];
+        int length_of_error_string;
+        MPI_Error_string(ret, error_string, &length_of_error_string);
+        printf("Error opening file: %s\n", error_string);
+        free(localData);
+        return NULL;
+    }
+
+    // File side: only the owned cells, no ghost layers
+    int globalSizes[4] = {args->nZ, args->nY, args->nX, timeSteps};
+    int subSizes[4] = {subdomain->depth, subdomain->height, subdomain->width, timeSteps};
+    int starts[4] = {subdomain->startZ, subdomain->startY, subdomain->startX, 0};
+
+    MPI_Datatype filetype;
+    MPI_Type_create_subarray(4, globalSizes, subSizes, starts, MPI_ORDER_C, MPI_FLOAT, &filetype);
+    MPI_Type_commit(&filetype);
+    MPI_File_set_view(fh, 0, MPI_FLOAT, filetype, "native", MPI_INFO_NULL);
+
+    // Memory side: the same cells inside the ghost frame of the padded block
+    const LocalBox owned = ownedBox(subdomain);
+    MPI_Datatype memtype = blockSubarray(subdomain, timeSteps, &owned);
+
+    MPI_Status status;
+    MPI_File_read_all(fh, localData, 1, memtype, &status);
+
+    int count;
+    int expected = subdomain->width * subdomain->height * subdomain->depth * timeSteps;
+    MPI_Get_count(&status, MPI_FLOAT, &count);
+    if (count != expected) {
+        printf("Error: Read %d elements, expected %d\n", count, expected);
+    }
+
+    MPI_Type_free(&memtype);
+    MPI_Type_free(&filetype);
+    MPI_File_close(&fh);
+
+    return localData;
+}
@@ -0,0 +1,41 @@
+#ifndef HALO_H
+#define HALO_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Faces of the padded block, in MPI_Cart_shift order per dimension
+enum { FACE_LOW_X, FACE_HIGH_X, FACE_LOW_Y, FACE_HIGH_Y, FACE_LOW_Z, FACE_HIGH_Z, FACE_COUNT };
+
+// Six-face ghost exchange on a pZ x pY x pX Cartesian communicator.
+// A face carries every timestep of the owned cells next to it; edges and corners
+// are never exchanged because the 7-point stencil does not read them.
+typedef struct {
+    MPI_Comm cart;                         // same rank numbering as calculateSubDomainBoundaries
+    int neighbours[FACE_COUNT];            // MPI_PROC_NULL on the global boundary
+    MPI_Datatype sendType[FACE_COUNT];     // owned plane next to the face
+    MPI_Datatype recvType[FACE_COUNT];     // ghost plane of the face
+    MPI_Request requests[2 * FACE_COUNT];
+    int requestCount;
+} HaloExchange;
+
+// Build the Cartesian communicator and the face datatypes for a padded point-major block
+bool haloCreate(HaloExchange* halo, const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm);
+
+// Post all face receives and sends; the owned cells of localData must not change until haloFinish
+void haloStart(HaloExchange* halo, float* localData);
+
+// Wait until every ghost face has arrived
+void haloFinish(HaloExchange* halo);
+
+void haloFree(HaloExchange* halo);
+
+// Owned cells that read no ghost cell: the owned box pulled in by one cell on every face
+// that has a neighbour. The rest of the owned box (splitShell) needs the finished exchange.
+LocalBox haloIndependentBox(const HaloExchange* halo, const SubDomain* subdomain);
+
+// Allocate the padded block and fill only its owned cells with one collective read
+// (file view over the owned cells, memory type placing them inside the ghost frame)
+float* readOwnedCells(const char* inputFile, const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm);
+
+#endif // HALO_H
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hints.h"
+
+#define HINTS_MAX 32
+#define HINTS_TEXT 4096
+
+// Derivation defaults (the values the collective readers used to hard-code)
+#define DEFAULT_STRIPING_UNIT 4194304L
+#define DEFAULT_BUFFER_STRIPES 4
+#define DEFAULT_AGGREGATORS_PER_NODE 1
+
+typedef struct {
+    char key[64];
+    char value[192];
+} Hint;
+
+typedef struct {
+    Hint items[HINTS_MAX];
+    int count;
+} HintSet;
+
+static const char* findHint(const HintSet* set, const char* key) {
+    for (int i = 0; i < set->count; i++) {
+        if (strcmp(set->items[i].key, key) == 0) return set->items[i].value;
+    }
+    return NULL;
+}
+
+// Insert or replace; later sources call this after earlier ones and win
+static void putHint(HintSet* set, const char* key, const char* value) {
+    for (int i = 0; i < set->count; i++) {
+        if (strcmp(set->items[i].key, key) == 0) {
+            snprintf(set->items[i].value, sizeof(set->items[i].value), "%s", value);
+            return;
+        }
+    }
+    if (set->count == HINTS_MAX) {
+        printf("Warning: more than %d MPI-IO hints, ignoring %s\n", HINTS_MAX, key);
+        return;
+    }
+    snprintf(set->items[set->count].key, sizeof(set->items[set->count].key), "%s", key);
+    snprintf(set->items[set->count].value, sizeof(set->items[set->count].value), "%s", value);
+    set->count++;
+}
+
+// "key=value" tokens separated by newlines, commas, semicolons or blanks
+static void parseHints(HintSet* set, char* text) {
+    for (char* token = strtok(text, "\n\r\t ,;"); token; token = strtok(NULL, "\n\r\t ,;")) {
+        char* equals = strchr(token, '=');
+        if (!equals || equals == token) {
+            printf("Warning: ignoring MPI-IO hint '%s' (expected key=value)\n", token);
+            continue;
+        }
+        *equals = '\0';
+        putHint(set, token, equals + 1);
+    }
+}
+
+// Append the hints file to text with comments removed; false if it cannot be read
+static bool appendHintsFile(const char* path, char* text, size_t capacity) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("Warning: cannot open MPI-IO hints file %s\n", path);
+        return false;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "#")] = '\0';
+        size_t used = strlen(text);
+        snprintf(text + used, capacity - used, "%s\n", line);
+    }
+    fclose(fp);
+    return true;
+}
+
+int nodeCount(MPI_Comm comm) {
+    int rank, nodeRank, leader, nodes;
+    MPI_Comm nodeComm;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodeComm);
+    MPI_Comm_rank(nodeComm, &nodeRank);
+    MPI_Comm_free(&nodeComm);
+
+    leader = nodeRank == 0 ? 1 : 0;
+    MPI_Allreduce(&leader, &nodes, 1, MPI_INT, MPI_SUM, comm);
+    return nodes;
+}
+
+MPI_Info createIoHints(const ProgramArgs* args, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    const int nodes = nodeCount(comm);
+
+    // Rank 0 gathers file and environment so every rank ends up with the same set
+    char text[HINTS_TEXT] = "";
+    if (rank == 0) {
+        if (args->ioHints[0] != '\0') appendHintsFile(args->ioHints, text, sizeof(text));
+        const char* env = getenv("TS_MPIIO_HINTS");
+        if (env) {
+            size_t used = strlen(text);
+            snprintf(text + used, sizeof(text) - used, "\n%s\n", env);
+        }
+    }
+    MPI_Bcast(text, HINTS_TEXT, MPI_CHAR, 0, comm);
+
+    HintSet user;
+    user.count = 0;
+    parseHints(&user, text);
+
+    const char* value;
+    long stripe = (value = findHint(&user, "striping_unit")) ? atol(value) : DEFAULT_STRIPING_UNIT;
+    int stripes = (value = findHint(&user, "buffer_stripes")) ? atoi(value) : DEFAULT_BUFFER_STRIPES;
+    int perNode = (value = findHint(&user, "aggregators_per_node")) ? atoi(value) : DEFAULT_AGGREGATORS_PER_NODE;
+    if (stripe <= 0) stripe = DEFAULT_STRIPING_UNIT;
+    if (stripes <= 0) stripes = DEFAULT_BUFFER_STRIPES;
+    if (perNode <= 0) perNode = DEFAULT_AGGREGATORS_PER_NODE;
+
+    // Aggregators scale with the nodes actually in the run; each aggregator's buffer
+    // is a whole number of stripes so its file accesses stay stripe aligned
+    int aggregators = nodes * perNode;
+    if (aggregators > size) aggregators = size;
+
+    HintSet hints;
+    hints.count = 0;
+    char number[32];
+    snprintf(number, sizeof(number), "%d", aggregators);
+    putHint(&hints, "cb_nodes", number);
+    snprintf(number, sizeof(number), "%ld", stripe * stripes);
+    putHint(&hints, "cb_buffer_size", number);
+    snprintf(number, sizeof(number), "%ld", stripe);
+    putHint(&hints, "striping_unit", number);
+    putHint(&hints, "romio_cb_read", "enable");
+    putHint(&hints, "romio_ds_read", "enable");
+
+    for (int i = 0; i < user.count; i++) {
+        const char* key = user.items[i].key;
+        if (strcmp(key, "aggregators_per_node") == 0 || strcmp(key, "buffer_stripes") == 0) continue;
+        putHint(&hints, key, user.items[i].value);
+    }
+
+    MPI_Info info;
+    MPI_Info_create(&info);
+    for (int i = 0; i < hints.count; i++) {
+        MPI_Info_set(info, hints.items[i].key, hints.items[i].value);
+    }
+    return info;
+}
+
+void reportIoHints(MPI_Info info, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank != 0) return;
+
+    int keys;
+    MPI_Info_get_nkeys(info, &keys);
+    printf("MPI-IO hints:");
+    for (int i = 0; i < keys; i++) {
+        char key[MPI_MAX_INFO_KEY + 1];
+        char value[256];
+        int found;
+        MPI_Info_get_nthkey(info, i, key);
+        MPI_Info_get(info, key, sizeof(value) - 1, value, &found);
+        if (found) printf(" %s=%s", key, value);
+    }
+    printf("\n");
+}
@@ -0,0 +1,24 @@
+#ifndef HINTS_H
+#define HINTS_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// MPI-IO hints for the collective readers. Later sources override earlier ones:
+//   1. derived defaults: cb_nodes = nodes * aggregators_per_node (capped at the rank count),
+//      cb_buffer_size = buffer_stripes * striping_unit, romio_cb_read/romio_ds_read = enable
+//   2. the --io-hints=FILE file, one key=value per line ('#' starts a comment)
+//   3. the TS_MPIIO_HINTS environment variable, "key=value" pairs separated by ',' ';' or spaces
+// aggregators_per_node (default 1) and buffer_stripes (default 4) only feed the derivation;
+// every other key, striping_unit (default 4194304) included, is passed to MPI verbatim.
+
+// Number of shared-memory nodes spanned by comm (collective)
+int nodeCount(MPI_Comm comm);
+
+// Collective over comm; the caller frees the result with MPI_Info_free
+MPI_Info createIoHints(const ProgramArgs* args, MPI_Comm comm);
+
+// Print the hints on rank 0 of comm as "MPI-IO hints: key=value ..."
+void reportIoHints(MPI_Info info, MPI_Comm comm);
+
+#endif // HINTS_H
@@ -0,0 +1,446 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "io.h"
+#include "distribute.h"
+#include "hints.h"
+#include "profile.h"
+#include "placement.h"
+
+// Heuristic thresholds: below this many bytes per rank the file system sees many tiny
+// requests and one sequential reader plus messages wins, as long as rank 0 can hold the file
+#define IO_SMALL_REQUEST_BYTES (512.0 * 1024.0)
+#define IO_ROOT_MAX_BYTES (1024.0 * 1024.0 * 1024.0)
+
+static const char* const strategyNames[] = {
+    "auto", "level0", "level1", "level2", "level3", "isend", "bsend"
+};
+
+const char* ioStrategyName(IoStrategy strategy) {
+    return strategyNames[strategy];
+}
+
+// Strategy of a calibration row: a strategy name, or one of benchmark.py's implementation labels
+static IoStrategy strategyFromLabel(const char* label) {
+    for (int s = IO_INDEPENDENT_ROWS; s <= IO_ROOT_BSEND; s++) {
+        if (strcmp(label, strategyNames[s]) == 0) return (IoStrategy)s;
+    }
+    if (strcmp(label, "ind_IO") == 0) return IO_INDEPENDENT_ROWS;
+    if (strcmp(label, "coll_IO") == 0) return IO_COLLECTIVE_ROWS;
+    if (strcmp(label, "ind_IO_der") == 0) return IO_INDEPENDENT_SUBARRAY;
+    if (strcmp(label, "coll_IO_der") == 0) return IO_COLLECTIVE_SUBARRAY;
+    return IO_AUTO;
+}
+
+// Split a CSV line in place; returns the number of fields (at most maxFields)
+static int splitFields(char* line, char** fields, int maxFields) {
+    int count = 0;
+    line[strcspn(line, "\r\n")] = '\0';
+    char* field = line;
+    while (count < maxFields) {
+        fields[count++] = field;
+        char* comma = strchr(field, ',');
+        if (!comma) break;
+        *comma = '\0';
+        field = comma + 1;
+    }
+    return count;
+}
+
+static int fieldIndex(char** fields, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(fields[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+#define CALIBRATION_MAX_FIELDS 64
+
+// Fastest strategy in a benchmark_results.csv at the rank count and then the problem
+// size closest to this run (log distance); IO_AUTO if the file has nothing usable
+static IoStrategy calibratedStrategy(const char* path, int ranks, double problemSize) {
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        printf("Warning: cannot open I/O calibration file %s\n", path);
+        return IO_AUTO;
+    }
+
+    char line[4096];
+    char* fields[CALIBRATION_MAX_FIELDS];
+    if (!fgets(line, sizeof(line), fp)) {
+        fclose(fp);
+        return IO_AUTO;
+    }
+    int count = splitFields(line, fields, CALIBRATION_MAX_FIELDS);
+    int strategyCol = fieldIndex(fields, count, "io_strategy");
+    int implCol = fieldIndex(fields, count, "implementation");
+    int procCol = fieldIndex(fields, count, "processes");
+    int sizeCol = fieldIndex(fields, count, "problem_size");
+    int timeCol = fieldIndex(fields, count, "total_time");
+    if ((strategyCol < 0 && implCol < 0) || procCol < 0 || sizeCol < 0 || timeCol < 0) {
+        printf("Warning: %s is not a benchmark_results.csv\n", path);
+        fclose(fp);
+        return IO_AUTO;
+    }
+
+    // Per strategy: best (rank distance, size distance) seen and the time sum at that point
+    double bestRanks = -1.0, bestSize = -1.0;
+    double timeSum[IO_ROOT_BSEND + 1] = {0.0};
+    int samples[IO_ROOT_BSEND + 1] = {0};
+
+    while (fgets(line, sizeof(line), fp)) {
+        int n = splitFields(line, fields, CALIBRATION_MAX_FIELDS);
+        if (n != count) continue;
+
+        IoStrategy strategy = IO_AUTO;
+        if (strategyCol >= 0) strategy = strategyFromLabel(fields[strategyCol]);
+        if (strategy == IO_AUTO && implCol >= 0) strategy = strategyFromLabel(fields[implCol]);
+        double rowRanks = atof(fields[procCol]);
+        double rowSize = atof(fields[sizeCol]);
+        if (strategy == IO_AUTO || rowRanks <= 0.0 || rowSize <= 0.0) continue;
+
+        double rankDistance = fabs(log(rowRanks / ranks));
+        double sizeDistance = fabs(log(rowSize / problemSize));
+
+        // A closer configuration restarts the averages
+        if (bestRanks < 0.0 || rankDistance < bestRanks ||
+            (rankDistance == bestRanks && sizeDistance < bestSize)) {
+            bestRanks = rankDistance;
+            bestSize = sizeDistance;
+            memset(timeSum, 0, sizeof(timeSum));
+            memset(samples, 0, sizeof(samples));
+        }
+        if (rankDistance == bestRanks && sizeDistance == bestSize) {
+            timeSum[strategy] += atof(fields[timeCol]);
+            samples[strategy]++;
+        }
+    }
+    fclose(fp);
+
+    IoStrategy best = IO_AUTO;
+    double bestTime = 0.0;
+    for (int s = IO_INDEPENDENT_ROWS; s <= IO_ROOT_BSEND; s++) {
+        if (samples[s] == 0) continue;
+        double mean = timeSum[s] / samples[s];
+        if (best == IO_AUTO || mean < bestTime) {
+            best = (IoStrategy)s;
+            bestTime = mean;
+        }
+    }
+    return best;
+}
+
+static IoStrategy heuristicStrategy(double fileBytes, int ranks, int nodes) {
+    if (ranks == 1) return IO_INDEPENDENT_SUBARRAY;
+
+    // Many small requests: read once on rank 0 and send the blocks
+    if (fileBytes / ranks < IO_SMALL_REQUEST_BYTES && fileBytes <= IO_ROOT_MAX_BYTES) {
+        return IO_ROOT_ISEND;
+    }
+
+    // Across nodes, collective buffering aggregates the strided subarray accesses
+    return nodes > 1 ? IO_COLLECTIVE_SUBARRAY : IO_INDEPENDENT_SUBARRAY;
+}
+
+IoDecision chooseIoStrategy(const ProgramArgs* args, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    const int nodes = nodeCount(comm);
+
+    IoDecision decision;
+    decision.fileBytes = (double)args->nX * args->nY * args->nZ * args->timeSteps * sizeof(float);
+    decision.ranks = size;
+    decision.nodes = nodes;
+    decision.strategy = args->ioStrategy;
+    decision.source = "override";
+
+    if (decision.strategy != IO_AUTO) return decision;
+
+    // Only rank 0 reads the calibration file; the choice is broadcast
+    int choice[2] = {IO_AUTO, 0};
+    if (rank == 0) {
+        if (args->ioCalibration[0] != '\0') {
+            choice[0] = calibratedStrategy(args->ioCalibration, size, decision.fileBytes / sizeof(float));
+            choice[1] = 1;
+
+            // The attached MPI_Bsend buffer has an int size
+            if (choice[0] == IO_ROOT_BSEND && decision.fileBytes > INT_MAX) choice[0] = IO_ROOT_ISEND;
+        }
+        if (choice[0] == IO_AUTO) {
+            choice[0] = heuristicStrategy(decision.fileBytes, size, nodes);
+            choice[1] = 0;
+        }
+    }
+    MPI_Bcast(choice, 2, MPI_INT, 0, comm);
+
+    decision.strategy = (IoStrategy)choice[0];
+    decision.source = choice[1] ? "calibration" : "heuristic";
+    return decision;
+}
+
+void reportIoDecision(const IoDecision* decision, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == 0) {
+        printf("I/O strategy: %s (%s; %.1f MiB, %d ranks on %d nodes)\n",
+               ioStrategyName(decision->strategy), decision->source,
+               decision->fileBytes / (1024.0 * 1024.0), decision->ranks, decision->nodes);
+    }
+}
+
+static MPI_File openInput(const char* inputFile, MPI_Info info, MPI_Comm comm) {
+    MPI_File fh;
+    profileBegin(PROFILE_OPEN);
+    int ret = MPI_File_open(comm, inputFile, MPI_MODE_RDONLY, info, &fh);
+    profileEnd(PROFILE_OPEN, 0);
+    if (ret != MPI_SUCCESS) {
+        char error_string[MPI_MAX_ERROR_STRING];
+        int length_of_error_string;
+        MPI_Error_string(ret, error_string, &length_of_error_string);
+        printf("Error opening file: %s\n", error_string);
+        return MPI_FILE_NULL;
+    }
+    return fh;
+}
+
+static void checkCount(const MPI_Status* status, long expected) {
+    int count;
+    MPI_Get_count(status, MPI_FLOAT, &count);
+    if (count != expected) {
+        printf("Error: Read %d elements, expected %ld\n", count, expected);
+    }
+}
+
+// Level 0/1: one read per x-row of the padded block
+static bool readRows(float* localData, const SubDomain* subdomain, const ProgramArgs* args,
+                     bool collective, MPI_Comm comm) {
+    MPI_Info info = collective ? createIoHints(args, comm) : MPI_INFO_NULL;
+    MPI_File fh = openInput(args->inputFile, info, comm);
+    if (fh == MPI_FILE_NULL) {
+        if (collective) MPI_Info_free(&info);
+        return false;
+    }
+
+    const int rowLength = subdomain->tempWidth * args->timeSteps;
+    const int rows = subdomain->tempHeight * subdomain->tempDepth;
+
+    // Balanced blocks differ in row count; collective calls must match, so ranks that
+    // run out of rows keep joining with empty reads
+    int maxRows = rows;
+    if (collective) MPI_Allreduce(&rows, &maxRows, 1, MPI_INT, MPI_MAX, comm);
+
+    MPI_Status status;
+    profileBegin(PROFILE_READ);
+    for (int r = 0; r < maxRows; r++) {
+        if (r < rows) {
+            int z = subdomain->tempStartZ + r / subdomain->tempHeight;
+            int y = subdomain->tempStartY + r % subdomain->tempHeight;
+            MPI_Offset offset = (MPI_Offset)getLinearIndex(subdomain->tempStartX, y, z, args->nX, args->nY, args->nZ) *
+                                args->timeSteps * sizeof(float);
+            float* row = localData + (long)r * rowLength;
+            if (collective) {
+                MPI_File_read_at_all(fh, offset, row, rowLength, MPI_FLOAT, &status);
+            } else {
+                MPI_File_read_at(fh, offset, row, rowLength, MPI_FLOAT, &status);
+            }
+            checkCount(&status, rowLength);
+        } else {
+            MPI_File_read_at_all(fh, 0, localData, 0, MPI_FLOAT, &status);
+        }
+    }
+    profileEnd(PROFILE_READ, (double)rows * rowLength * sizeof(float));
+
+    MPI_File_close(&fh);
+    if (collective) MPI_Info_free(&info);
+    return true;
+}
+
+// Level 2/3: the padded block as a subarray file view, read in one call
+static bool readSubarray(float* localData, const SubDomain* subdomain, const ProgramArgs* args,
+                         bool collective, MPI_Comm comm) {
+    MPI_Info info = collective ? createIoHints(args, comm) : MPI_INFO_NULL;
+    MPI_File fh = openInput(args->inputFile, info, comm);
+    if (fh == MPI_FILE_NULL) {
+        if (collective) MPI_Info_free(&info);
+        return false;
+    }
+
+    const long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                               subdomain->tempDepth * args->timeSteps;
+    profileBegin(PROFILE_VIEW);
+    MPI_Datatype filetype = createBlockType(subdomain, args->nX, args->nY, args->nZ, args->timeSteps, MPI_FLOAT);
+    MPI_File_set_view(fh, 0, MPI_FLOAT, filetype, "native", info);
+    profileEnd(PROFILE_VIEW, 0);
+
+    MPI_Status status;
+    profileBegin(PROFILE_READ);
+    if (collective) {
+        MPI_File_read_all(fh, localData, (int)localDataSize, MPI_FLOAT, &status);
+    } else {
+        MPI_File_read(fh, localData, (int)localDataSize, MPI_FLOAT, &status);
+    }
+    profileEnd(PROFILE_READ, (double)localDataSize * sizeof(float));
+    checkCount(&status, localDataSize);
+
+    MPI_Type_free(&filetype);
+    MPI_File_close(&fh);
+    if (collective) MPI_Info_free(&info);
+    return true;
+}
+
+// The whole file on rank 0 (sequential stdio read)
+static float* readWholeFile(const ProgramArgs* args) {
+    const size_t total = (size_t)args->nX * args->nY * args->nZ * args->timeSteps;
+    float* data = (float*)malloc(total * sizeof(float));
+    if (!data) {
+        printf("Failed to allocate memory for input data\n");
+        return NULL;
+    }
+
+    profileBegin(PROFILE_OPEN);
+    FILE* fp = fopen(args->inputFile, "rb");
+    profileEnd(PROFILE_OPEN, 0);
+    if (!fp) {
+        printf("Failed to open input file: %s\n", args->inputFile);
+        free(data);
+        return NULL;
+    }
+
+    profileBegin(PROFILE_READ);
+    size_t itemsRead = fread(data, sizeof(float), total, fp);
+    profileEnd(PROFILE_READ, (double)itemsRead * sizeof(float));
+    fclose(fp);
+    if (itemsRead != total) {
+        printf("Error reading data: expected %zu items, got %zu\n", total, itemsRead);
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+// Root read + one message per rank (rank 0 included) described by a subarray type
+static bool readAndDistribute(float* localData, const SubDomain* subdomain, const ProgramArgs* args,
+                              bool buffered, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Rank 0 reports a failed read through the broadcast so no rank waits forever
+    float* globalData = NULL;
+    int ok = 1;
+    if (rank == 0) {
+        globalData = readWholeFile(args);
+        ok = globalData != NULL;
+    }
+    MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+    if (!ok) return false;
+
+    const long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                               subdomain->tempDepth * args->timeSteps;
+    MPI_Request recvRequest;
+    MPI_Irecv(localData, (int)localDataSize, MPI_FLOAT, 0, 0, comm, &recvRequest);
+
+    if (rank == 0) {
+        MPI_Datatype* types = (MPI_Datatype*)malloc(size * sizeof(MPI_Datatype));
+        MPI_Request* requests = (MPI_Request*)malloc(size * sizeof(MPI_Request));
+        if (!types || !requests) {
+            printf("Rank 0: Failed to allocate memory for requests\n");
+            MPI_Abort(comm, 1);
+        }
+
+        long bufferSize = 0;
+        for (int p = 0; p < size; p++) {
+            SubDomain block;
+            calculateSubDomainBoundaries(p, args->pX, args->pY, args->pZ, args->nX, args->nY, args->nZ, &block);
+            types[p] = createBlockType(&block, args->nX, args->nY, args->nZ, args->timeSteps, MPI_FLOAT);
+
+            MPI_Count typeBytes;
+            MPI_Type_size_x(types[p], &typeBytes);
+            bufferSize += (long)typeBytes + MPI_BSEND_OVERHEAD;
+        }
+
+        void* bsendBuffer = NULL;
+        if (buffered) {
+            // MPI_Buffer_attach takes an int size
+            if (bufferSize > INT_MAX) {
+                printf("Rank 0: MPI_Bsend needs a %ld byte buffer, more than MPI_Buffer_attach accepts; "
+                       "use --io-strategy=isend\n", bufferSize);
+                MPI_Abort(comm, 1);
+            }
+            bsendBuffer = malloc(bufferSize);
+            if (!bsendBuffer) {
+                printf("Rank 0: Failed to allocate bsend buffer\n");
+                MPI_Abort(comm, 1);
+            }
+            MPI_Buffer_attach(bsendBuffer, (int)bufferSize);
+        }
+
+        profileBegin(PROFILE_SEND);
+        double sentBytes = 0;
+        for (int p = 0; p < size; p++) {
+            MPI_Count typeBytes;
+            MPI_Type_size_x(types[p], &typeBytes);
+            sentBytes += (double)typeBytes;
+            if (buffered) {
+                MPI_Bsend(globalData, 1, types[p], p, 0, comm);
+            } else {
+                MPI_Isend(globalData, 1, types[p], p, 0, comm, &requests[p]);
+            }
+            MPI_Type_free(&types[p]);
+        }
+        profileEnd(PROFILE_SEND, sentBytes);
+
+        profileBegin(PROFILE_WAIT);
+        if (buffered) {
+            void* buf;
+            int bufSize;
+            MPI_Buffer_detach(&buf, &bufSize);
+            free(buf);
+        } else {
+            MPI_Waitall(size, requests, MPI_STATUSES_IGNORE);
+        }
+        profileEnd(PROFILE_WAIT, 0);
+        free(requests);
+        free(types);
+        free(globalData);
+    }
+
+    profileBegin(PROFILE_WAIT);
+    MPI_Wait(&recvRequest, MPI_STATUS_IGNORE);
+    profileEnd(PROFILE_WAIT, (double)localDataSize * sizeof(float));
+    return true;
+}
+
+float* readBlock(IoStrategy strategy, const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm) {
+    const long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                               subdomain->tempDepth * args->timeSteps;
+
+    float* localData = (float*)allocateLocalBlock(subdomain, localDataSize * sizeof(float));
+    if (!localData) {
+        printf("Failed to allocate memory for local data\n");
+        return NULL;
+    }
+
+    bool ok = false;
+    switch (strategy) {
+        case IO_INDEPENDENT_ROWS:     ok = readRows(localData, subdomain, args, false, comm); break;
+        case IO_COLLECTIVE_ROWS:      ok = readRows(localData, subdomain, args, true, comm); break;
+        case IO_INDEPENDENT_SUBARRAY: ok = readSubarray(localData, subdomain, args, false, comm); break;
+        case IO_COLLECTIVE_SUBARRAY:  ok = readSubarray(localData, subdomain, args, true, comm); break;
+        case IO_ROOT_ISEND:           ok = readAndDistribute(localData, subdomain, args, false, comm); break;
+        case IO_ROOT_BSEND:           ok = readAndDistribute(localData, subdomain, args, true, comm); break;
+        case IO_AUTO:
+            printf("Error: readBlock needs a concrete I/O strategy\n");
+            break;
+    }
+
+    if (!ok) {
+        free(localData);
+        return NULL;
+    }
+    return localData;
+}
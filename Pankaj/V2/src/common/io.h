@@ -0,0 +1,32 @@
+#ifndef IO_H
+#define IO_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Runtime choice between the read strategies of the implementations, so the same
+// binary can move between file systems and machine sizes without recompiling.
+typedef struct {
+    IoStrategy strategy;      // never IO_AUTO
+    const char* source;       // "override", "calibration" or "heuristic"
+    double fileBytes;
+    int ranks;
+    int nodes;
+} IoDecision;
+
+// Command line name of a strategy ("level2", "isend", ...)
+const char* ioStrategyName(IoStrategy strategy);
+
+// Collective over comm; every rank gets the same decision. An explicit --io-strategy wins;
+// otherwise rank 0 consults --io-calibration (fastest strategy measured at the nearest rank
+// count and problem size) and falls back to a heuristic on bytes per rank and node count.
+IoDecision chooseIoStrategy(const ProgramArgs* args, MPI_Comm comm);
+
+// Print the decision on rank 0 of comm
+void reportIoDecision(const IoDecision* decision, MPI_Comm comm);
+
+// Fill a newly allocated padded block [z][y][x][t] with the given strategy (not IO_AUTO).
+// Collective over comm, whose ranks follow calculateSubDomainBoundaries. NULL on failure.
+float* readBlock(IoStrategy strategy, const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm);
+
+#endif // IO_H
@@ -0,0 +1,90 @@
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mapped.h"
+#include "distribute.h"
+#include "hints.h"
+
+bool mapBlock(MappedBlock* block, const SubDomain* subdomain, int elementSize,
+              const ProgramArgs* args, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    memset(block, 0, sizeof(*block));
+
+    // Page-cache sharing only holds within a node; elsewhere every node faults in its own copy
+    if (nodeCount(comm) > 1 && rank == 0) {
+        printf("Warning: mapped input across several nodes; each node reads the file itself\n");
+    }
+
+    int fd = open(args->inputFile, O_RDONLY);
+    if (fd < 0) {
+        printf("Rank %d: Failed to open input file: %s\n", rank, args->inputFile);
+        return false;
+    }
+
+    const size_t seriesBytes = (size_t)args->timeSteps * elementSize;
+    const size_t length = (size_t)args->nX * args->nY * args->nZ * seriesBytes;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < length) {
+        printf("Rank %d: %s is shorter than %zu bytes\n", rank, args->inputFile, length);
+        close(fd);
+        return false;
+    }
+
+    void* map = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("Rank %d: Failed to map %s\n", rank, args->inputFile);
+        return false;
+    }
+    block->map = map;
+    block->length = length;
+
+    // The kernel walks rows in increasing address order; prefetch the slab this rank needs
+    madvise(map, length, MADV_SEQUENTIAL);
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t first = (size_t)getLinearIndex(subdomain->tempStartX, subdomain->tempStartY, subdomain->tempStartZ,
+                                          args->nX, args->nY, args->nZ) * seriesBytes;
+    size_t last = (size_t)(getLinearIndex(subdomain->tempEndX, subdomain->tempEndY, subdomain->tempEndZ,
+                                          args->nX, args->nY, args->nZ) + 1) * seriesBytes;
+    first -= first % page;
+    madvise((char*)map + first, last - first, MADV_WILLNEED);
+
+    if (rootAnalysesInPlace(args)) {
+        block->data = map;
+        block->view = wholeDomainView(subdomain, args->nX, args->nY, args->nZ);
+        return true;
+    }
+
+    // The transposing and device kernels need their own padded block; copy it out of the page cache
+    const size_t rowBytes = (size_t)subdomain->tempWidth * seriesBytes;
+    char* local = (char*)malloc((size_t)subdomain->tempDepth * subdomain->tempHeight * rowBytes);
+    if (!local) {
+        printf("Rank %d: Failed to allocate memory for local data\n", rank);
+        unmapBlock(block);
+        return false;
+    }
+    char* dst = local;
+    for (int z = subdomain->tempStartZ; z <= subdomain->tempEndZ; z++) {
+        for (int y = subdomain->tempStartY; y <= subdomain->tempEndY; y++) {
+            size_t src = (size_t)getLinearIndex(subdomain->tempStartX, y, z, args->nX, args->nY, args->nZ) * seriesBytes;
+            memcpy(dst, (const char*)map + src, rowBytes);
+            dst += rowBytes;
+        }
+    }
+    block->data = local;
+    block->view = *subdomain;
+    block->copied = true;
+    return true;
+}
+
+void unmapBlock(MappedBlock* block) {
+    if (block->copied) free(block->data);
+    if (block->map) munmap(block->map, block->length);
+    memset(block, 0, sizeof(*block));
+}
@@ -0,0 +1,27 @@
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include <stddef.h>
+#include "mpi.h"
+#include "timeseries.h"
+
+// Memory-mapped input for node-local runs: every rank maps the raw file read-only, so
+// the node shares one copy in the page cache and ghost layers are never read twice.
+// With a point-major, non-SIMD kernel the analysis runs on the mapping itself.
+typedef struct {
+    void* map;                // PROT_READ mapping of the whole file
+    size_t length;
+    void* data;               // what the kernel reads: the mapping or a copied padded block
+    SubDomain view;           // subdomain matching data (whole-domain view when in place)
+    bool copied;              // data is a malloc'd padded block (time-major / SIMD kernels)
+} MappedBlock;
+
+// Map args->inputFile (elements of elementSize bytes) and advise the kernel: sequential
+// access over the file, prefetch of the z-range this rank's padded block touches.
+// Warns when comm spans several nodes. False if the file cannot be mapped or copied.
+bool mapBlock(MappedBlock* block, const SubDomain* subdomain, int elementSize,
+              const ProgramArgs* args, MPI_Comm comm);
+
+void unmapBlock(MappedBlock* block);
+
+#endif // MAPPED_H
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nodeshare.h"
+#include "distribute.h"
+#include "placement.h"
+#include "profile.h"
+
+bool nodeDistribute(NodeSharedBlock* block, const void* globalData, MPI_Datatype elementType,
+                    const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm) {
+    int rank, nodeRank;
+    MPI_Comm_rank(comm, &rank);
+
+    // Keying by rank keeps rank 0 of comm as the leader of its node and as leaderComm rank 0
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &block->nodeComm);
+    MPI_Comm_rank(block->nodeComm, &nodeRank);
+    MPI_Comm_split(comm, nodeRank == 0 ? 0 : MPI_UNDEFINED, rank, &block->leaderComm);
+
+    // Bounding box of the padded blocks on this node, as inclusive {lo x, y, z, hi x, y, z}
+    int lo[3] = {subdomain->tempStartX, subdomain->tempStartY, subdomain->tempStartZ};
+    int hi[3] = {subdomain->tempEndX, subdomain->tempEndY, subdomain->tempEndZ};
+    int box[6];
+    MPI_Allreduce(lo, box, 3, MPI_INT, MPI_MIN, block->nodeComm);
+    MPI_Allreduce(hi, box + 3, 3, MPI_INT, MPI_MAX, block->nodeComm);
+
+    const int boxSizes[4] = {box[5] - box[2] + 1, box[4] - box[1] + 1, box[3] - box[0] + 1, args->timeSteps};
+    const long boxCount = (long)boxSizes[0] * boxSizes[1] * boxSizes[2] * boxSizes[3];
+
+    // A node whose ranks are not contiguous in the process grid gets a box spanning the gaps
+    // between them; compare it with the padded blocks it has to hold
+    long padded = (long)subdomain->tempWidth * subdomain->tempHeight * subdomain->tempDepth;
+    long nodePadded;
+    MPI_Allreduce(&padded, &nodePadded, 1, MPI_LONG, MPI_SUM, block->nodeComm);
+    double boxRatio = (double)boxSizes[0] * boxSizes[1] * boxSizes[2] / nodePadded;
+    double maxBoxRatio;
+    MPI_Reduce(&boxRatio, &maxBoxRatio, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+    if (rank == 0 && maxBoxRatio > 1.0) {
+        printf("Warning: a node block is %.1fx the padded blocks of its ranks; the ranks of a node "
+               "are not contiguous in the %d x %d x %d grid\n", maxBoxRatio, args->pX, args->pY, args->pZ);
+    }
+
+    // Only the leader contributes memory; the others map the leader's segment
+    int elementSize;
+    MPI_Type_size(elementType, &elementSize);
+    MPI_Aint bytes = nodeRank == 0 ? (MPI_Aint)boxCount * elementSize : 0;
+
+    void* base;
+    int ret = MPI_Win_allocate_shared(bytes, elementSize, MPI_INFO_NULL, block->nodeComm, &base, &block->win);
+    if (ret != MPI_SUCCESS) {
+        printf("Rank %d: Failed to allocate the node shared window\n", rank);
+        return false;
+    }
+
+    MPI_Aint segmentSize;
+    int dispUnit;
+    MPI_Win_shared_query(block->win, 0, &segmentSize, &dispUnit, &block->data);
+
+    MPI_Win_fence(0, block->win);
+
+    if (block->leaderComm != MPI_COMM_NULL) {
+        int leaders;
+        MPI_Comm_size(block->leaderComm, &leaders);
+
+        int* boxes = NULL;
+        if (rank == 0) {
+            boxes = (int*)malloc(leaders * 6 * sizeof(int));
+            if (!boxes) {
+                printf("Rank 0: Failed to allocate node boxes\n");
+                MPI_Abort(comm, 1);
+            }
+        }
+        MPI_Gather(box, 6, MPI_INT, boxes, 6, MPI_INT, 0, block->leaderComm);
+
+        // A node block can hold more values than an int count (the whole domain on one node);
+        // received as x-rows the count stays at the number of rows
+        MPI_Datatype rowType;
+        MPI_Type_contiguous(boxSizes[2] * args->timeSteps, elementType, &rowType);
+        MPI_Type_commit(&rowType);
+        MPI_Request recvRequest;
+        MPI_Irecv(block->data, boxSizes[0] * boxSizes[1], rowType, 0, 0, block->leaderComm, &recvRequest);
+
+        if (rank == 0) {
+            // One send per node, described by a subarray type: no pack buffers on the root
+            MPI_Request* requests = (MPI_Request*)malloc(leaders * sizeof(MPI_Request));
+            if (!requests) {
+                printf("Rank 0: Failed to allocate requests\n");
+                MPI_Abort(comm, 1);
+            }
+
+            int globalSizes[4] = {args->nZ, args->nY, args->nX, args->timeSteps};
+            for (int l = 0; l < leaders; l++) {
+                const int* b = boxes + 6 * l;
+                int subSizes[4] = {b[5] - b[2] + 1, b[4] - b[1] + 1, b[3] - b[0] + 1, args->timeSteps};
+                int starts[4] = {b[2], b[1], b[0], 0};
+
+                MPI_Datatype nodeType;
+                MPI_Type_create_subarray(4, globalSizes, subSizes, starts, MPI_ORDER_C, elementType, &nodeType);
+                MPI_Type_commit(&nodeType);
+                MPI_Isend(globalData, 1, nodeType, l, 0, block->leaderComm, &requests[l]);
+                MPI_Type_free(&nodeType);
+            }
+
+            MPI_Waitall(leaders, requests, MPI_STATUSES_IGNORE);
+            free(requests);
+            free(boxes);
+        }
+
+        MPI_Wait(&recvRequest, MPI_STATUS_IGNORE);
+        MPI_Type_free(&rowType);
+    }
+
+    // The node block is complete once the leader reaches the fence
+    MPI_Win_fence(0, block->win);
+
+    if (!rootAnalysesInPlace(args)) {
+        // The transposing and device kernels would copy the whole node block on every rank;
+        // take only this rank's padded block out of the window and release the window
+        const size_t seriesBytes = (size_t)args->timeSteps * elementSize;
+        const size_t rowBytes = (size_t)subdomain->tempWidth * seriesBytes;
+        const size_t localBytes = (size_t)subdomain->tempDepth * subdomain->tempHeight * rowBytes;
+        char* local = (char*)allocateLocalBlock(subdomain, localBytes);
+        if (!local) {
+            printf("Rank %d: Failed to allocate memory for local data\n", rank);
+            return false;
+        }
+
+        profileBegin(PROFILE_PACK);
+        char* dst = local;
+        for (int z = subdomain->tempStartZ; z <= subdomain->tempEndZ; z++) {
+            for (int y = subdomain->tempStartY; y <= subdomain->tempEndY; y++) {
+                size_t src = (((size_t)(z - box[2]) * boxSizes[1] + (y - box[1])) * boxSizes[2] +
+                              (subdomain->tempStartX - box[0])) * seriesBytes;
+                memcpy(dst, (const char*)block->data + src, rowBytes);
+                dst += rowBytes;
+            }
+        }
+        profileEnd(PROFILE_PACK, (double)localBytes);
+
+        MPI_Win_free(&block->win);
+        block->data = local;
+        block->view = *subdomain;
+        return true;
+    }
+
+    // Same owned cells; the padded block becomes the node block. It contains every ghost
+    // cell of this rank and only ends where the global domain ends next to owned cells,
+    // so the kernel's neighbour-existence tests give the same answers.
+    block->view = *subdomain;
+    block->view.tempStartX = box[0];
+    block->view.tempStartY = box[1];
+    block->view.tempStartZ = box[2];
+    block->view.tempEndX = box[3];
+    block->view.tempEndY = box[4];
+    block->view.tempEndZ = box[5];
+    block->view.tempWidth = boxSizes[2];
+    block->view.tempHeight = boxSizes[1];
+    block->view.tempDepth = boxSizes[0];
+
+    return true;
+}
+
+void nodeSharedFree(NodeSharedBlock* block) {
+    if (block->win != MPI_WIN_NULL) {
+        MPI_Win_free(&block->win);
+    } else {
+        free(block->data);
+    }
+    if (block->leaderComm != MPI_COMM_NULL) MPI_Comm_free(&block->leaderComm);
+    MPI_Comm_free(&block->nodeComm);
+    block->data = NULL;
+}
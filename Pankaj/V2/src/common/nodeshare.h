@@ -0,0 +1,32 @@
+#ifndef NODESHARE_H
+#define NODESHARE_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Hierarchical distribution: rank 0 sends one block per node to the node leaders, each
+// leader receives it straight into an MPI-3 shared window, and every rank of the node
+// analyses its part of that window in place. Kernels that transpose or upload their block
+// (see rootAnalysesInPlace) copy only their own padded block out instead, and the window
+// is released before the analysis.
+//
+// The node block is the bounding box of the node's padded blocks, so it only saves memory
+// when the ranks of a node are contiguous in the process grid; a warning is printed when it
+// is larger than the blocks it holds. Rank 0 keeps globalData until the distribution
+// returns, so its node block is a second copy of that part of the domain in the meantime.
+typedef struct {
+    MPI_Comm nodeComm;        // ranks sharing memory with this one (MPI_COMM_TYPE_SHARED)
+    MPI_Comm leaderComm;      // node rank 0 of every node; MPI_COMM_NULL elsewhere
+    MPI_Win win;              // MPI_WIN_NULL once the rank's own block has been copied out
+    void* data;               // node block [z][y][x][t], or this rank's own padded block
+    SubDomain view;           // this rank's subdomain as laid out in data
+} NodeSharedBlock;
+
+// Distribute globalData (significant on rank 0 of comm only) with element type
+// MPI_FLOAT or MPI_DOUBLE. Collective over comm; false if the window cannot be created.
+bool nodeDistribute(NodeSharedBlock* block, const void* globalData, MPI_Datatype elementType,
+                    const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm);
+
+void nodeSharedFree(NodeSharedBlock* block);
+
+#endif // NODESHARE_H
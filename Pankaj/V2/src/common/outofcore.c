@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "outofcore.h"
+#include "profile.h"
+
+// Analyse owned planes [first, last) of the padded block, held in buffer from padded plane base on
+static void analyzeSlab(const void* buffer, MPI_Datatype elementType, const SubDomain* subdomain,
+                        int base, int held, int first, int last, TimeSeriesResults* results,
+                        const ProgramArgs* args) {
+    // The buffer is a padded block of its own, shifted in z; planes outside it are never
+    // analysed, so the kernels' existence checks still match the real block
+    SubDomain window = *subdomain;
+    window.tempStartZ = subdomain->tempStartZ + base;
+    window.tempEndZ = window.tempStartZ + held - 1;
+    window.tempDepth = held;
+
+    LocalBox box = ownedBox(&window);
+    if (box.z0 < first - base) box.z0 = first - base;
+    if (box.z1 > last - base) box.z1 = last - base;
+    if (isEmptyBox(&box)) return;
+
+    if (elementType == MPI_DOUBLE) {
+        analyzeLocalBoxDouble((const double*)buffer, &window, &box, results, args);
+    } else {
+        analyzeLocalBox((const float*)buffer, &window, &box, results, args);
+    }
+}
+
+bool outOfCoreAnalyze(const SubDomain* subdomain, const ProgramArgs* args, MPI_Datatype elementType,
+                      MPI_Info info, MPI_Comm comm, TimeSeriesResults* results, OutOfCoreStats* stats) {
+    const int depth = subdomain->tempDepth;
+    const long elementSize = elementType == MPI_DOUBLE ? sizeof(double) : sizeof(float);
+    const long planeElements = (long)subdomain->tempWidth * subdomain->tempHeight * args->timeSteps;
+    const long limit = args->memoryLimit > 0 ? args->memoryLimit : OUT_OF_CORE_DEFAULT_LIMIT;
+
+    memset(stats, 0, sizeof(*stats));
+
+    // A slab holds the plane being analysed and both its neighbours at least
+    long capacity = limit / (planeElements * elementSize);
+    if (capacity > depth) capacity = depth;
+    if (capacity * planeElements > INT_MAX) capacity = INT_MAX / planeElements;
+    int fits = capacity >= 3 || capacity == depth;
+    int allFit;
+    MPI_Allreduce(&fits, &allFit, 1, MPI_INT, MPI_LAND, comm);
+    if (!allFit) {
+        if (!fits) {
+            printf("Error: --memory-limit=%ld holds %ld z-planes of %ld bytes, at least 3 are needed\n",
+                   limit, capacity, planeElements * elementSize);
+        }
+        return false;
+    }
+    stats->planesPerSlab = (int)capacity;
+    stats->bufferBytes = (double)capacity * planeElements * elementSize;
+
+    // First slab fills the buffer, later ones the capacity - 2 planes above the carried pair
+    int myReads = 1;
+    if (depth > capacity) myReads += (int)((depth - capacity + capacity - 3) / (capacity - 2));
+    int reads;
+    MPI_Allreduce(&myReads, &reads, 1, MPI_INT, MPI_MAX, comm);
+    stats->reads = reads;
+
+    char* buffer = (char*)malloc(capacity * planeElements * elementSize);
+    int ok = buffer != NULL;
+    int allOk;
+    MPI_Allreduce(&ok, &allOk, 1, MPI_INT, MPI_LAND, comm);
+    if (!allOk) {
+        if (!ok) printf("Failed to allocate the %ld-plane slab buffer\n", capacity);
+        free(buffer);
+        return false;
+    }
+
+    MPI_File fh;
+    profileBegin(PROFILE_OPEN);
+    int ret = MPI_File_open(comm, args->inputFile, MPI_MODE_RDONLY, info, &fh);
+    profileEnd(PROFILE_OPEN, 0);
+    if (ret != MPI_SUCCESS) {
+        char error_string[MPI_MAX_ERROR_STRING];
+        int length_of_error_string;
+        MPI_Error_string(ret, error_string, &length_of_error_string);
+        printf("Error opening file: %s\n", error_string);
+        free(buffer);
+        return false;
+    }
+
+    // One view over the whole padded block: a run of z-planes is contiguous in it
+    int globalSizes[4] = {args->nZ, args->nY, args->nX, args->timeSteps};
+    int subSizes[4] = {subdomain->tempDepth, subdomain->tempHeight, subdomain->tempWidth, args->timeSteps};
+    int starts[4] = {subdomain->tempStartZ, subdomain->tempStartY, subdomain->tempStartX, 0};
+
+    MPI_Datatype filetype;
+    profileBegin(PROFILE_VIEW);
+    MPI_Type_create_subarray(4, globalSizes, subSizes, starts, MPI_ORDER_C, elementType, &filetype);
+    MPI_Type_commit(&filetype);
+    MPI_File_set_view(fh, 0, elementType, filetype, "native", info);
+    profileEnd(PROFILE_VIEW, 0);
+
+    // base: padded plane in buffer[0]; held: planes in the buffer; next: next plane to read;
+    // analysed: planes below it are done
+    int base = 0, held = 0, next = 0, analysed = 0;
+    for (int r = 0; r < reads; r++) {
+        // Ranks with fewer slabs join the collective with an empty read
+        int count = (int)(capacity - held < depth - next ? capacity - held : depth - next);
+        if (count < 0) count = 0;
+
+        double readStart = MPI_Wtime();
+        profileBegin(PROFILE_READ);
+        ret = MPI_File_read_at_all(fh, (MPI_Offset)next * planeElements, buffer + held * planeElements * elementSize,
+                                   (int)(count * planeElements), elementType, MPI_STATUS_IGNORE);
+        profileEnd(PROFILE_READ, (double)count * planeElements * elementSize);
+        stats->readTime += MPI_Wtime() - readStart;
+        if (ret != MPI_SUCCESS) {
+            printf("Error: reading padded planes %d-%d failed\n", next, next + count - 1);
+            ok = 0;
+        }
+        if (count == 0) continue;
+        stats->bytesRead += (double)count * planeElements * elementSize;
+        held += count;
+        next += count;
+
+        // A plane can be analysed once the plane above it is in (or it is the top of the block)
+        const int top = base + held;
+        const int ready = top == depth ? top : top - 1;
+        double analysisStart = MPI_Wtime();
+        analyzeSlab(buffer, elementType, subdomain, base, held, analysed, ready, results, args);
+        stats->analysisTime += MPI_Wtime() - analysisStart;
+        analysed = ready;
+
+        // Carry the unfinished plane and its lower neighbour into the next slab
+        if (next < depth) {
+            memmove(buffer, buffer + (held - 2) * planeElements * elementSize, 2 * planeElements * elementSize);
+            base = top - 2;
+            held = 2;
+        }
+    }
+
+    MPI_Type_free(&filetype);
+    MPI_File_close(&fh);
+    free(buffer);
+
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, comm);
+    return ok;
+}
+
+void reportOutOfCoreStats(const OutOfCoreStats* stats, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    double local[4] = {stats->bufferBytes, stats->bytesRead, stats->readTime, stats->analysisTime};
+    double worst[4];
+    int fewestPlanes;
+    MPI_Reduce(local, worst, 4, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce(&stats->planesPerSlab, &fewestPlanes, 1, MPI_INT, MPI_MIN, 0, comm);
+
+    if (rank == 0) {
+        printf("Out-of-core: %d slab reads of up to %d z-planes, buffer %.2f MB, read %.2f MB "
+               "(read %.4fs, analysis %.4fs, max over ranks)\n",
+               stats->reads, fewestPlanes, worst[0] / (1024 * 1024), worst[1] / (1024 * 1024), worst[2], worst[3]);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef OUTOFCORE_H
+#define OUTOFCORE_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Default slab buffer per rank when --memory-limit is not given
+#define OUT_OF_CORE_DEFAULT_LIMIT (256L * 1024 * 1024)
+
+// What the out-of-core walk did on one rank
+typedef struct {
+    int planesPerSlab;        // buffer capacity in padded z-planes
+    int reads;                // slab reads issued (the same on every rank)
+    double bufferBytes;
+    double bytesRead;
+    double readTime;
+    double analysisTime;
+} OutOfCoreStats;
+
+// Analyse the padded block without ever holding it whole: it is walked bottom to top in
+// z-slabs of as many planes as fit args->memoryLimit bytes, each read with one
+// MPI_File_read_at_all through a subarray view of the padded block. The top two planes of a
+// slab (the last plane that still lacks its upper neighbour, and the plane below it) move to
+// the bottom of the buffer, so every plane is read once. Owned planes are analysed in place
+// with the point-major kernels and accumulated into results. Collective over comm; false on
+// every rank if a slab of three planes does not fit some rank's limit or a read fails.
+bool outOfCoreAnalyze(const SubDomain* subdomain, const ProgramArgs* args, MPI_Datatype elementType,
+                      MPI_Info info, MPI_Comm comm, TimeSeriesResults* results, OutOfCoreStats* stats);
+
+// Print the max over ranks of the statistics on rank 0 of comm
+void reportOutOfCoreStats(const OutOfCoreStats* stats, MPI_Comm comm);
+
+#endif // OUTOFCORE_H
@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "pipeline.h"
+#include "placement.h"
+
+// Padded z planes [*first, *last) of slab j out of slabs (empty when slabs > tempDepth)
+static void slabPlanes(const SubDomain* subdomain, int slabs, int j, int* first, int* last) {
+    *first = (int)((long)subdomain->tempDepth * j / slabs);
+    *last = (int)((long)subdomain->tempDepth * (j + 1) / slabs);
+}
+
+static void postSlab(MPI_File fh, float* localData, const SubDomain* subdomain, int timeSteps,
+                     int slabs, int j, bool collective, MPI_Request* request) {
+    const long planeSize = (long)subdomain->tempWidth * subdomain->tempHeight * timeSteps;
+    int first, last;
+    slabPlanes(subdomain, slabs, j, &first, &last);
+
+    // The view is the whole padded block, so a slab is one contiguous run of it
+    MPI_Offset offset = (MPI_Offset)first * planeSize;
+    int count = (int)((last - first) * planeSize);
+
+    if (collective) {
+        MPI_File_iread_at_all(fh, offset, localData + offset, count, MPI_FLOAT, request);
+    } else {
+        MPI_File_iread_at(fh, offset, localData + offset, count, MPI_FLOAT, request);
+    }
+}
+
+// Owned planes in padded z range [first, last)
+static void analyzePlanes(const float* localData, const SubDomain* subdomain, const ProgramArgs* args,
+                          int first, int last, TimeSeriesResults* results) {
+    LocalBox box = ownedBox(subdomain);
+    if (box.z0 < first) box.z0 = first;
+    if (box.z1 > last) box.z1 = last;
+
+    if (!isEmptyBox(&box)) {
+        analyzeLocalBox(localData, subdomain, &box, results, args);
+    }
+}
+
+float* pipelinedReadAndAnalyze(const char* inputFile, const SubDomain* subdomain, const ProgramArgs* args,
+                               int slabs, bool collective, MPI_Info info, MPI_Comm comm,
+                               TimeSeriesResults* results, PipelineStats* stats) {
+    const int timeSteps = args->timeSteps;
+    long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                         subdomain->tempDepth * timeSteps;
+
+    stats->slabs = slabs;
+    stats->waitTime = 0.0;
+    stats->overlapTime = 0.0;
+    stats->analysisTime = 0.0;
+    stats->readsDoneEarly = 0;
+
+    float* localData = (float*)allocateLocalBlock(subdomain, localDataSize * sizeof(float));
+    if (!localData) {
+        printf("Failed to allocate memory for local data\n");
+        return NULL;
+    }
+
+    MPI_File fh;
+    int ret = MPI_File_open(comm, inputFile, MPI_MODE_RDONLY, info, &fh);
+    if (ret != MPI_SUCCESS) {
+        char error_string[MPI_MAX_ERROR_STRING];
+        int length_of_error_string;
+        MPI_Error_string(ret, error_string, &length_of_error_string);
+        printf("Error opening file: %s\n", error_string);
+        free(localData);
+        return NULL;
+    }
+
+    int globalSizes[4] = {args->nZ, args->nY, args->nX, timeSteps};
+    int subSizes[4] = {subdomain->tempDepth, subdomain->tempHeight, subdomain->tempWidth, timeSteps};
+    int starts[4] = {subdomain->tempStartZ, subdomain->tempStartY, subdomain->tempStartX, 0};
+
+    MPI_Datatype filetype;
+    MPI_Type_create_subarray(4, globalSizes, subSizes, starts, MPI_ORDER_C, MPI_FLOAT, &filetype);
+    MPI_Type_commit(&filetype);
+    MPI_File_set_view(fh, 0, MPI_FLOAT, filetype, "native", info);
+
+    // Every rank issues the same number of reads (possibly empty) so the collective
+    // variant stays matched even when tempDepth differs between ranks
+    MPI_Request request;
+    postSlab(fh, localData, subdomain, timeSteps, slabs, 0, collective, &request);
+
+    // Planes below `ready` have been analysed; a plane can be analysed once the plane
+    // above it has landed, so the last plane of every arrived slab waits for the next one
+    int ready = 0;
+    for (int j = 0; j < slabs; j++) {
+        int done;
+        MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+        if (done) {
+            stats->readsDoneEarly++;
+        } else {
+            double waitStart = MPI_Wtime();
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            stats->waitTime += MPI_Wtime() - waitStart;
+        }
+
+        bool reading = j + 1 < slabs;
+        if (reading) {
+            postSlab(fh, localData, subdomain, timeSteps, slabs, j + 1, collective, &request);
+        }
+
+        int first, last;
+        slabPlanes(subdomain, slabs, j, &first, &last);
+        int limit = reading ? last - 1 : subdomain->tempDepth;
+        if (limit > ready) {
+            double analysisStart = MPI_Wtime();
+            analyzePlanes(localData, subdomain, args, ready, limit, results);
+            double elapsed = MPI_Wtime() - analysisStart;
+            stats->analysisTime += elapsed;
+            if (reading) stats->overlapTime += elapsed;
+            ready = limit;
+        }
+    }
+
+    MPI_Type_free(&filetype);
+    MPI_File_close(&fh);
+
+    return localData;
+}
+
+void reportPipelineStats(const PipelineStats* stats, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    double local[3] = {stats->waitTime, stats->overlapTime, stats->analysisTime};
+    double worst[3];
+    int fewestEarly;
+    MPI_Reduce(local, worst, 3, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce(&stats->readsDoneEarly, &fewestEarly, 1, MPI_INT, MPI_MIN, 0, comm);
+
+    if (rank == 0) {
+        // Reads that finished before they were needed were hidden completely; for the
+        // others the overlapped analysis time is what was taken off the critical path
+        printf("Pipeline: %d slabs, exposed I/O wait %.4fs, I/O hidden behind %.4fs of analysis "
+               "(%.4fs total), %d/%d reads complete before needed\n",
+               stats->slabs, worst[0], worst[1], worst[2], fewestEarly, stats->slabs);
+    }
+}
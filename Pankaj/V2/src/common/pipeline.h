@@ -0,0 +1,28 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// How much of the read the pipelined reader kept off the critical path (per rank)
+typedef struct {
+    int slabs;
+    double waitTime;          // blocked in MPI_Wait for a slab (exposed I/O)
+    double overlapTime;       // analysis run while a slab read was in flight
+    double analysisTime;      // all analysis
+    int readsDoneEarly;       // slab reads already complete when first needed
+} PipelineStats;
+
+// Read the padded block as `slabs` z-slabs with non-blocking MPI-IO (MPI_File_iread_at_all
+// when collective, MPI_File_iread_at otherwise). Once slab k has landed, slab k+1 is posted and
+// every owned plane whose upper neighbour plane is now present is analysed meanwhile.
+// The point-major kernels run in place; --kernel=simd / --layout=time fall back to fused.
+// Returns the filled padded block (caller frees) or NULL on failure.
+float* pipelinedReadAndAnalyze(const char* inputFile, const SubDomain* subdomain, const ProgramArgs* args,
+                               int slabs, bool collective, MPI_Info info, MPI_Comm comm,
+                               TimeSeriesResults* results, PipelineStats* stats);
+
+// Print the max over ranks of the pipeline statistics on rank 0 of comm
+void reportPipelineStats(const PipelineStats* stats, MPI_Comm comm);
+
+#endif // PIPELINE_H
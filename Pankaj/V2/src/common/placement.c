@@ -0,0 +1,270 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <dirent.h>
+#include "placement.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PLACEMENT_TEXT 64
+
+// Where one rank runs, as it sees it
+typedef struct {
+    char host[PLACEMENT_TEXT];
+    char cpus[PLACEMENT_TEXT];    // allowed CPUs, "0-3,8"
+    int node;                     // lowest rank on the same host
+    int socket;                   // package of every allowed CPU, -1 if they span several
+    int numa;                     // NUMA node of every allowed CPU, -1 likewise
+    int cpu;                      // CPU running the call
+    int cpuCount;
+} RankPlacement;
+
+// Rank at each grid position and the inverse; NULL while the grid is in rank order
+static int* gridOrder = NULL;
+static int* gridIndex = NULL;
+
+#ifdef _OPENMP
+// Threads the kernels will sweep a block with, for the first touch
+static int touchThreads = 1;
+#endif
+
+int placementGridIndex(int rank) {
+    return gridIndex ? gridIndex[rank] : rank;
+}
+
+int placementRankAt(int index) {
+    return gridOrder ? gridOrder[index] : index;
+}
+
+// Integer in a sysfs file, -1 if there is none
+static int readSysInt(const char* path) {
+    FILE* fp = fopen(path, "r");
+    int value = -1;
+    if (fp) {
+        if (fscanf(fp, "%d", &value) != 1) value = -1;
+        fclose(fp);
+    }
+    return value;
+}
+
+// NUMA node of cpu: the "nodeN" entry of its sysfs directory, -1 if there is none
+static int numaNodeOf(int cpu) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR* dir = opendir(path);
+    int node = -1;
+    if (dir) {
+        struct dirent* entry;
+        while (node < 0 && (entry = readdir(dir)) != NULL) {
+            if (strncmp(entry->d_name, "node", 4) == 0) node = atoi(entry->d_name + 4);
+        }
+        closedir(dir);
+    }
+    return node;
+}
+
+// Append "a" or "a-b" to the CPU list, "..." once it is full
+static void appendRange(char* list, int first, int last) {
+    char range[32];
+    if (first == last) snprintf(range, sizeof(range), "%s%d", *list ? "," : "", first);
+    else snprintf(range, sizeof(range), "%s%d-%d", *list ? "," : "", first, last);
+
+    if (strstr(list, "...")) return;
+    if (strlen(list) + strlen(range) < PLACEMENT_TEXT - 4) strcat(list, range);
+    else strcat(list, "...");
+}
+
+static void localPlacement(RankPlacement* placement, MPI_Comm comm) {
+    memset(placement, 0, sizeof(*placement));
+    int length = 0;
+    char host[MPI_MAX_PROCESSOR_NAME];
+    MPI_Get_processor_name(host, &length);
+    snprintf(placement->host, sizeof(placement->host), "%.*s", PLACEMENT_TEXT - 1, host);
+
+    // The host is named by its lowest rank
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm nodeComm;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &nodeComm);
+    placement->node = rank;
+    MPI_Bcast(&placement->node, 1, MPI_INT, 0, nodeComm);
+    MPI_Comm_free(&nodeComm);
+
+    placement->socket = -1;
+    placement->numa = -1;
+    placement->cpu = sched_getcpu();
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        snprintf(placement->cpus, sizeof(placement->cpus), "unknown");
+        return;
+    }
+
+    int first = -1;
+    for (int cpu = 0; cpu <= CPU_SETSIZE; cpu++) {
+        const bool allowed = cpu < CPU_SETSIZE && CPU_ISSET(cpu, &set);
+        if (allowed) {
+            char path[128];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+            const int socket = readSysInt(path);
+            const int numa = numaNodeOf(cpu);
+            if (placement->cpuCount == 0) {
+                placement->socket = socket;
+                placement->numa = numa;
+            } else {
+                if (socket != placement->socket) placement->socket = -1;
+                if (numa != placement->numa) placement->numa = -1;
+            }
+            placement->cpuCount++;
+            if (first < 0) first = cpu;
+        } else if (first >= 0) {
+            appendRange(placement->cpus, first, cpu - 1);
+            first = -1;
+        }
+    }
+}
+
+// {node, socket, rank} sorted so a socket's ranks are consecutive; unbound ranks first
+static int compareKeys(const void* a, const void* b) {
+    const int* x = (const int*)a;
+    const int* y = (const int*)b;
+    for (int i = 0; i < 3; i++) {
+        if (x[i] != y[i]) return x[i] < y[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static bool sameSocket(const RankPlacement* a, const RankPlacement* b) {
+    return a->node == b->node && a->socket >= 0 && a->socket == b->socket;
+}
+
+static void printReport(const RankPlacement* all, const ProgramArgs* args, int size) {
+    printf("Placement: process grid in %s order\n", args->placement == PLACEMENT_SOCKET ? "socket" : "rank");
+    printf("  rank  host              grid (x, y, z)  socket  numa  cpu  allowed CPUs\n");
+
+    int unbound = 0;
+    for (int r = 0; r < size; r++) {
+        const RankPlacement* p = &all[r];
+        const int index = placementGridIndex(r);
+        char grid[48];
+        snprintf(grid, sizeof(grid), "(%d, %d, %d)", index % args->pX, (index / args->pX) % args->pY,
+                 index / (args->pX * args->pY));
+        printf("  %4d  %-16.16s  %-14s  %6d  %4d  %3d  %s\n", r, p->host, grid, p->socket, p->numa, p->cpu, p->cpus);
+        if (p->socket < 0) unbound++;
+    }
+
+    // Neighbours along x and y of the grid whose ranks run on one socket
+    int pairs = 0, shared = 0;
+    for (int index = 0; index < size; index++) {
+        const int x = index % args->pX;
+        const int y = (index / args->pX) % args->pY;
+        const RankPlacement* here = &all[placementRankAt(index)];
+        if (x + 1 < args->pX) {
+            pairs++;
+            shared += sameSocket(here, &all[placementRankAt(index + 1)]);
+        }
+        if (y + 1 < args->pY) {
+            pairs++;
+            shared += sameSocket(here, &all[placementRankAt(index + args->pX)]);
+        }
+    }
+    printf("  x/y neighbour pairs on one socket: %d of %d\n", shared, pairs);
+    if (unbound > 0) {
+        printf("Warning: %d of %d ranks may run on more than one socket; bind them "
+               "(mpirun --bind-to core|socket) for NUMA-local memory\n", unbound, size);
+    }
+}
+
+bool placementInit(const ProgramArgs* args, MPI_Comm comm) {
+#ifdef _OPENMP
+    touchThreads = args->threads > 0 ? args->threads : omp_get_max_threads();
+#endif
+    free(gridOrder);
+    free(gridIndex);
+    gridOrder = NULL;
+    gridIndex = NULL;
+    if (args->placement == PLACEMENT_RANK && !args->bindReport) return true;
+
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    RankPlacement mine;
+    localPlacement(&mine, comm);
+
+    RankPlacement* all = (RankPlacement*)malloc(size * sizeof(RankPlacement));
+    int* keys = (int*)malloc(3 * (size_t)size * sizeof(int));
+    int* order = (int*)malloc(size * sizeof(int));
+    int* index = (int*)malloc(size * sizeof(int));
+    int ok = all && keys && order && index;
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!ok) {
+        if (rank == 0) printf("Error: Failed to allocate the placement tables\n");
+        free(all);
+        free(keys);
+        free(order);
+        free(index);
+        return false;
+    }
+    MPI_Allgather(&mine, sizeof(RankPlacement), MPI_BYTE, all, sizeof(RankPlacement), MPI_BYTE, comm);
+
+    if (args->placement == PLACEMENT_SOCKET) {
+        for (int r = 0; r < size; r++) {
+            keys[3 * r] = all[r].node;
+            keys[3 * r + 1] = all[r].socket;
+            keys[3 * r + 2] = r;
+        }
+        qsort(keys, size, 3 * sizeof(int), compareKeys);
+        for (int i = 0; i < size; i++) {
+            order[i] = keys[3 * i + 2];
+            index[order[i]] = i;
+        }
+        gridOrder = order;
+        gridIndex = index;
+        order = NULL;
+        index = NULL;
+    }
+
+    if (args->bindReport && rank == 0) printReport(all, args, size);
+
+    free(all);
+    free(keys);
+    free(order);
+    free(index);
+    return true;
+}
+
+void* allocateLocalBlock(const SubDomain* subdomain, size_t bytes) {
+    char* block = (char*)malloc(bytes > 0 ? bytes : 1);
+
+#ifdef _OPENMP
+    // Zero each tile's x-rows (all timesteps of a padded row are contiguous) on the thread
+    // that analyzeThreaded will give the tile; ghost planes are left to the first writer
+    const int threads = touchThreads;
+    const LocalBox owned = ownedBox(subdomain);
+    const int tileCount = block && threads > 1 && bytes > 0 ? splitTiles(&owned, threads, NULL) : 0;
+    LocalBox* tiles = tileCount > 0 ? (LocalBox*)malloc(tileCount * sizeof(LocalBox)) : NULL;
+    if (tiles) {
+        const size_t rowBytes = bytes / ((size_t)subdomain->tempHeight * subdomain->tempDepth);
+        splitTiles(&owned, threads, tiles);
+
+        #pragma omp parallel for num_threads(threads) schedule(static)
+        for (int i = 0; i < tileCount; i++) {
+            for (int z = tiles[i].z0; z < tiles[i].z1; z++) {
+                char* rows = block + ((size_t)z * subdomain->tempHeight + tiles[i].y0) * rowBytes;
+                memset(rows, 0, (size_t)(tiles[i].y1 - tiles[i].y0) * rowBytes);
+            }
+        }
+        free(tiles);
+    }
+#else
+    (void)subdomain;
+#endif
+
+    return block;
+}
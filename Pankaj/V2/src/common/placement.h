@@ -0,0 +1,33 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "mpi.h"
+#include "timeseries.h"
+
+// Rank placement and NUMA-local buffers.
+//   --bind-report=1     rank 0 prints every rank's host, allowed CPUs, socket and NUMA node
+//                       and how many x/y neighbour pairs of the process grid share a socket
+//   --placement=socket  grid positions (x fastest, then y, then z) go to the ranks in
+//                       (node, socket, rank) order instead of rank order, so whatever the
+//                       launcher's mapping, the ranks of a socket hold consecutive x-rows and
+//                       xy-planes. Needs bound ranks (mpirun --bind-to core|socket).
+// calculateSubDomainBoundaries and the halo exchange go through the order set here.
+// allocateLocalBlock allocates padded blocks the way the threaded kernels will use them.
+
+// Collective over comm: record the grid order and the compute threads for first touch
+// (parseArguments calls it). False if the order table cannot be allocated.
+bool placementInit(const ProgramArgs* args, MPI_Comm comm);
+
+// Grid position (rank in x-fastest grid order) of rank, and the rank at a grid position
+int placementGridIndex(int rank);
+int placementRankAt(int index);
+
+// Malloc a padded block of bytes for subdomain. In OpenMP builds with more than one compute
+// thread its pages are first touched by the thread that will sweep them (the tiles and
+// static schedule of the threaded kernels), so they land on that thread's NUMA node
+// before MPI fills them. NULL on failure.
+void* allocateLocalBlock(const SubDomain* subdomain, size_t bytes);
+
+#endif // PLACEMENT_H
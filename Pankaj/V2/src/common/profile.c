@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "profile.h"
+
+#define TRACE_EVENTS 65536
+
+static const char* const regionNames[PROFILE_REGIONS] = {
+    "open", "view", "read", "decompress", "pack", "send", "wait", "compute", "reduce", "write"
+};
+
+typedef struct {
+    double time;
+    double bytes;
+    double calls;
+    double start;
+    int depth;
+} RegionTotals;
+
+static RegionTotals regions[PROFILE_REGIONS];
+
+// Trace events as {region, start, end} triples; tracing is decided on first use
+static double* traceEvents = NULL;
+static int traceCount = 0;
+static int tracing = -1;
+
+static bool traceEnabled(void) {
+    if (tracing < 0) {
+        const char* env = getenv("TS_PROFILE_TRACE");
+        tracing = env && strcmp(env, "0") != 0 ? 1 : 0;
+        if (tracing) {
+            traceEvents = (double*)malloc(TRACE_EVENTS * 3 * sizeof(double));
+            if (!traceEvents) tracing = 0;
+        }
+    }
+    return tracing == 1;
+}
+
+void profileBegin(ProfileRegion region) {
+    RegionTotals* r = &regions[region];
+    if (r->depth++ == 0) r->start = MPI_Wtime();
+}
+
+void profileEnd(ProfileRegion region, double bytes) {
+    RegionTotals* r = &regions[region];
+    r->bytes += bytes;
+    if (--r->depth > 0) return;
+
+    double end = MPI_Wtime();
+    r->time += end - r->start;
+    r->calls++;
+
+    if (traceEnabled() && traceCount < TRACE_EVENTS) {
+        traceEvents[3 * traceCount] = region;
+        traceEvents[3 * traceCount + 1] = r->start;
+        traceEvents[3 * traceCount + 2] = end;
+        traceCount++;
+    }
+}
+
+static void writeTrace(const char* outputFile, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    int* counts = NULL;
+    int* displs = NULL;
+    double* all = NULL;
+    int values = traceCount * 3;
+    if (rank == 0) counts = (int*)malloc(size * sizeof(int));
+    MPI_Gather(&values, 1, MPI_INT, counts, 1, MPI_INT, 0, comm);
+
+    int total = 0;
+    if (rank == 0) {
+        displs = (int*)malloc(size * sizeof(int));
+        for (int p = 0; p < size; p++) {
+            displs[p] = total;
+            total += counts[p];
+        }
+        all = (double*)malloc((total > 0 ? total : 1) * sizeof(double));
+    }
+    MPI_Gatherv(traceEvents, values, MPI_DOUBLE, all, counts, displs, MPI_DOUBLE, 0, comm);
+
+    if (rank == 0) {
+        char path[300];
+        snprintf(path, sizeof(path), "%s.trace.json", outputFile);
+        FILE* fp = fopen(path, "w");
+        if (fp) {
+            // Times relative to the earliest event, in microseconds
+            double origin = total > 0 ? all[1] : 0.0;
+            for (int i = 0; i < total; i += 3) {
+                if (all[i + 1] < origin) origin = all[i + 1];
+            }
+            fprintf(fp, "{\"traceEvents\": [");
+            for (int p = 0, first = 1; p < size; p++) {
+                for (int i = displs[p]; i < displs[p] + counts[p]; i += 3, first = 0) {
+                    fprintf(fp, "%s\n  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                            first ? "" : ",", regionNames[(int)all[i]], p,
+                            (all[i + 1] - origin) * 1e6, (all[i + 2] - all[i + 1]) * 1e6);
+                }
+            }
+            fprintf(fp, "\n]}\n");
+            fclose(fp);
+        } else {
+            printf("Error: Cannot create %s\n", path);
+        }
+    }
+
+    free(counts);
+    free(displs);
+    free(all);
+}
+
+void profileReport(const char* outputFile, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // {time, bytes, calls} per region and rank, in one gather
+    double local[PROFILE_REGIONS * 3];
+    for (int i = 0; i < PROFILE_REGIONS; i++) {
+        local[3 * i] = regions[i].time;
+        local[3 * i + 1] = regions[i].bytes;
+        local[3 * i + 2] = regions[i].calls;
+    }
+    double* all = NULL;
+    if (rank == 0) {
+        all = (double*)malloc((size_t)size * PROFILE_REGIONS * 3 * sizeof(double));
+        if (!all) {
+            printf("Rank 0: Failed to allocate the profile buffer\n");
+            MPI_Abort(comm, 1);
+        }
+    }
+    MPI_Gather(local, PROFILE_REGIONS * 3, MPI_DOUBLE, all, PROFILE_REGIONS * 3, MPI_DOUBLE, 0, comm);
+
+    if (rank == 0) {
+        char path[300];
+        snprintf(path, sizeof(path), "%s.profile.json", outputFile);
+        FILE* fp = fopen(path, "w");
+        if (!fp) {
+            printf("Error: Cannot create %s\n", path);
+        } else {
+            fprintf(fp, "{\n  \"ranks\": %d,\n  \"regions\": {", size);
+            int written = 0;
+            for (int i = 0; i < PROFILE_REGIONS; i++) {
+                double minTime = all[3 * i], maxTime = all[3 * i], sum = 0.0, bytes = 0.0, calls = 0.0;
+                int slowest = 0;
+                for (int p = 0; p < size; p++) {
+                    const double* v = all + (size_t)p * PROFILE_REGIONS * 3 + 3 * i;
+                    if (v[0] < minTime) minTime = v[0];
+                    if (v[0] > maxTime) { maxTime = v[0]; slowest = p; }
+                    sum += v[0];
+                    bytes += v[1];
+                    calls += v[2];
+                }
+                if (calls == 0) continue;
+
+                double mean = sum / size;
+                fprintf(fp, "%s\n    \"%s\": {\"calls\": %.0f, \"min\": %.9g, \"mean\": %.9g, \"max\": %.9g, "
+                        "\"slowest_rank\": %d, \"imbalance\": %.4f, \"bytes\": %.0f, \"gbps\": %.4f}",
+                        written++ ? "," : "", regionNames[i], calls, minTime, mean, maxTime, slowest,
+                        mean > 0 ? maxTime / mean : 1.0, bytes, maxTime > 0 ? bytes / maxTime / 1e9 : 0.0);
+            }
+            fprintf(fp, "\n  }\n}\n");
+            fclose(fp);
+        }
+        free(all);
+    }
+
+    int trace = traceEnabled();
+    MPI_Allreduce(MPI_IN_PLACE, &trace, 1, MPI_INT, MPI_MAX, comm);
+    if (trace) writeTrace(outputFile, comm);
+}
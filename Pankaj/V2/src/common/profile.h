@@ -0,0 +1,36 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "mpi.h"
+
+// Lightweight per-rank instrumentation of the hot path. Each region accumulates wall
+// time (MPI_Wtime), calls and bytes moved; nested entries of the same region count once.
+// profileReport gathers every rank's totals and rank 0 writes "<outputFile>.profile.json":
+// per region min / mean / max time over ranks, the slowest rank, the imbalance ratio
+// max / mean, total bytes and the GB/s achieved at the slowest rank's time.
+// With TS_PROFILE_TRACE=1 in the environment each region entry is also recorded, and the
+// events of all ranks are written as a Chrome trace-event file "<outputFile>.trace.json"
+// (loads in Perfetto / chrome://tracing, one row per rank).
+typedef enum {
+    PROFILE_OPEN,             // MPI_File_open / fopen
+    PROFILE_VIEW,             // file view and datatype setup
+    PROFILE_READ,             // file reads
+    PROFILE_DECOMPRESS,       // inflating compressed input
+    PROFILE_PACK,             // copies and transposes of local data
+    PROFILE_SEND,             // posting or performing point-to-point sends
+    PROFILE_WAIT,             // waiting for messages to complete
+    PROFILE_COMPUTE,          // extrema kernel
+    PROFILE_REDUCE,           // result reductions
+    PROFILE_WRITE,            // writing the output
+    PROFILE_REGIONS
+} ProfileRegion;
+
+void profileBegin(ProfileRegion region);
+
+// Close the region and credit it with bytes moved (0 if not meaningful)
+void profileEnd(ProfileRegion region, double bytes);
+
+// Collective over comm: write the breakdown (and trace) next to outputFile on rank 0
+void profileReport(const char* outputFile, MPI_Comm comm);
+
+#endif // PROFILE_H
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "state.h"
+
+#define STATE_VERSION 2
+
+void resultsStatePath(const ProgramArgs* args, char* path, size_t capacity) {
+    snprintf(path, capacity, "%s.state", args->outputFile);
+}
+
+// Timesteps read from the side-car, 0 if it is missing or does not describe this run
+static int readState(const ProgramArgs* args, TimeSeriesResults* results) {
+    char path[300];
+    resultsStatePath(args, path, sizeof(path));
+    FILE* fp = fopen(path, "r");
+    if (!fp) return 0;
+
+    // The input path has a line of its own, so it may hold blanks
+    int version, nX, nY, nZ;
+    char input[1024];
+    if (fscanf(fp, "tsstate %d %d %d %d", &version, &nX, &nY, &nZ) != 4 || version != STATE_VERSION ||
+        fgetc(fp) != '\n' || !fgets(input, sizeof(input), fp)) {
+        printf("Warning: %s is not a results state file, starting over\n", path);
+        fclose(fp);
+        return 0;
+    }
+    input[strcspn(input, "\n")] = '\0';
+    if (nX != args->nX || nY != args->nY || nZ != args->nZ || strcmp(input, args->inputFile) != 0) {
+        printf("Warning: %s was written for %s (%d x %d x %d), starting over\n", path, input, nX, nY, nZ);
+        fclose(fp);
+        return 0;
+    }
+
+    int t = 0;
+    int minima, maxima;
+    double minValue, maxValue;
+    while (fscanf(fp, "%d %d %lf %lf", &minima, &maxima, &minValue, &maxValue) == 4) {
+        if (t == args->timeSteps) {
+            printf("Warning: %s holds more timesteps than the %d in the file, starting over\n",
+                   path, args->timeSteps);
+            fclose(fp);
+            return 0;
+        }
+        results->minimaCount[t] = minima;
+        results->maximaCount[t] = maxima;
+        results->minValues[t] = minValue;
+        results->maxValues[t] = maxValue;
+        t++;
+    }
+    fclose(fp);
+    return t;
+}
+
+int loadResultsState(const ProgramArgs* args, TimeSeriesResults* results, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    int stored = 0;
+    if (rank == 0) stored = readState(args, results);
+    MPI_Bcast(&stored, 1, MPI_INT, 0, comm);
+    return stored;
+}
+
+bool appendResultsState(const ProgramArgs* args, const TimeSeriesResults* results, int t0, int t1) {
+    char path[300];
+    resultsStatePath(args, path, sizeof(path));
+    FILE* fp = fopen(path, t0 == 0 ? "w" : "a");
+    if (!fp) {
+        printf("Error: Cannot open state file %s\n", path);
+        return false;
+    }
+
+    if (t0 == 0) {
+        fprintf(fp, "tsstate %d %d %d %d\n%s\n", STATE_VERSION, args->nX, args->nY, args->nZ, args->inputFile);
+    }
+    for (int t = t0; t < t1; t++) {
+        fprintf(fp, "%d %d %.17g %.17g\n", results->minimaCount[t], results->maximaCount[t],
+                results->minValues[t], results->maxValues[t]);
+    }
+    fclose(fp);
+    return true;
+}
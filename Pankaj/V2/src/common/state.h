@@ -0,0 +1,25 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Side-car of per-timestep results for incremental runs, "<outputFile>.state":
+//   tsstate 2 <nX> <nY> <nZ>
+//   <inputFile>                                            (the whole line, blanks included)
+//   <minimaCount> <maximaCount> <minValue> <maxValue>     (one line per timestep)
+// Values are printed with 17 significant digits so they read back exactly. New
+// timesteps are appended; earlier lines are never rewritten.
+
+// Path of the state side-car for args->outputFile
+void resultsStatePath(const ProgramArgs* args, char* path, size_t capacity);
+
+// Load up to args->timeSteps stored timesteps into results (rank 0 only; results may be
+// NULL elsewhere) and broadcast how many were found. 0 when there is no state, it was
+// written for other dimensions or another input, or it holds more timesteps than the file.
+int loadResultsState(const ProgramArgs* args, TimeSeriesResults* results, MPI_Comm comm);
+
+// Append timesteps [t0, t1) of results to the side-car, starting a new one when t0 is 0
+bool appendResultsState(const ProgramArgs* args, const TimeSeriesResults* results, int t0, int t1);
+
+#endif // STATE_H
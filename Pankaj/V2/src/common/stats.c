@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats.h"
+#include "profile.h"
+
+// Doubles per StatsPoint
+#define POINT_FIELDS 4
+
+static ExtendedStats* accumulator = NULL;
+
+static const StatsPoint emptyPoint = {0.0, -1.0, -1.0, -1.0};
+
+// Whether a ranks above b: lower (minima) or higher (maxima) value, then the lower z, y, x;
+// an empty slot ranks below everything
+static bool ranksAbove(const StatsPoint* a, const StatsPoint* b, bool minima) {
+    if (b->x < 0) return a->x >= 0;
+    if (a->x < 0) return false;
+    if (a->value != b->value) return minima ? a->value < b->value : a->value > b->value;
+    if (a->z != b->z) return a->z < b->z;
+    if (a->y != b->y) return a->y < b->y;
+    return a->x < b->x;
+}
+
+static int compareMinima(const void* a, const void* b) {
+    return ranksAbove((const StatsPoint*)a, (const StatsPoint*)b, true) ? -1 :
+           ranksAbove((const StatsPoint*)b, (const StatsPoint*)a, true) ? 1 : 0;
+}
+
+static int compareMaxima(const void* a, const void* b) {
+    return ranksAbove((const StatsPoint*)a, (const StatsPoint*)b, false) ? -1 :
+           ranksAbove((const StatsPoint*)b, (const StatsPoint*)a, false) ? 1 : 0;
+}
+
+// Replace the root of a k-heap (worst entry on top) by point if it ranks above it
+static void offerHeap(StatsPoint* heap, int k, const StatsPoint* point, bool minima) {
+    if (!ranksAbove(point, &heap[0], minima)) return;
+
+    // Sift point down from the root past every child that ranks below it
+    int i = 0;
+    for (;;) {
+        const int left = 2 * i + 1, right = left + 1;
+        int worst = -1;
+        const StatsPoint* worstPoint = point;
+        if (left < k && ranksAbove(worstPoint, &heap[left], minima)) worstPoint = &heap[worst = left];
+        if (right < k && ranksAbove(worstPoint, &heap[right], minima)) worstPoint = &heap[worst = right];
+        if (worst < 0) break;
+        heap[i] = heap[worst];
+        i = worst;
+    }
+    heap[i] = *point;
+}
+
+ExtendedStats* statsCreate(const ProgramArgs* args, int timeSteps) {
+    ExtendedStats* stats = (ExtendedStats*)calloc(1, sizeof(ExtendedStats));
+    if (!stats) return NULL;
+
+    stats->timeSteps = timeSteps;
+    stats->topK = args->topK;
+    stats->thresholdCount = args->thresholdCount;
+    memcpy(stats->thresholds, args->thresholds, sizeof(stats->thresholds));
+    stats->bins = args->histogramBins;
+    stats->low = args->histogramLow;
+    stats->high = args->histogramHigh;
+    stats->countsPerStep = 1 + stats->thresholdCount + (stats->bins > 0 ? stats->bins + 2 : 0);
+
+    const size_t points = (size_t)timeSteps * stats->topK;
+    stats->minima = (StatsPoint*)malloc((points > 0 ? points : 1) * sizeof(StatsPoint));
+    stats->maxima = (StatsPoint*)malloc((points > 0 ? points : 1) * sizeof(StatsPoint));
+    stats->counts = (long long*)calloc((size_t)timeSteps * stats->countsPerStep + 1, sizeof(long long));
+    if (!stats->minima || !stats->maxima || !stats->counts) {
+        statsFree(stats);
+        return NULL;
+    }
+    for (size_t i = 0; i < points; i++) {
+        stats->minima[i] = emptyPoint;
+        stats->maxima[i] = emptyPoint;
+    }
+    return stats;
+}
+
+void statsFree(ExtendedStats* stats) {
+    if (!stats) return;
+    free(stats->minima);
+    free(stats->maxima);
+    free(stats->counts);
+    free(stats);
+}
+
+// Fresh statistics of timeSteps timesteps holding everything stats has seen
+static ExtendedStats* grow(ExtendedStats* stats, const ProgramArgs* args, int timeSteps) {
+    ExtendedStats* grown = statsCreate(args, timeSteps);
+    if (!grown) return NULL;
+    if (stats) {
+        const size_t points = (size_t)stats->timeSteps * stats->topK;
+        memcpy(grown->minima, stats->minima, points * sizeof(StatsPoint));
+        memcpy(grown->maxima, stats->maxima, points * sizeof(StatsPoint));
+        memcpy(grown->counts, stats->counts, (size_t)stats->timeSteps * stats->countsPerStep * sizeof(long long));
+        statsFree(stats);
+    }
+    return grown;
+}
+
+ExtendedStats* statsFor(const ProgramArgs* args) {
+    if (!statsRequested(args)) return NULL;
+
+    const int needed = args->stepOffset + args->timeSteps;
+    if (!accumulator || accumulator->timeSteps < needed) {
+        ExtendedStats* grown = grow(accumulator, args, needed);
+        if (!grown) {
+            printf("Error: Failed to allocate the statistics of %d timesteps\n", needed);
+            return NULL;
+        }
+        accumulator = grown;
+    }
+    return accumulator;
+}
+
+void statsOfferMinimum(ExtendedStats* stats, int t, double value, int x, int y, int z) {
+    if (stats->topK == 0) return;
+    const StatsPoint point = {value, x, y, z};
+    offerHeap(stats->minima + (size_t)t * stats->topK, stats->topK, &point, true);
+}
+
+void statsOfferMaximum(ExtendedStats* stats, int t, double value, int x, int y, int z) {
+    if (stats->topK == 0) return;
+    const StatsPoint point = {value, x, y, z};
+    offerHeap(stats->maxima + (size_t)t * stats->topK, stats->topK, &point, false);
+}
+
+void statsMerge(ExtendedStats* stats, const ExtendedStats* partial) {
+    const int k = stats->topK;
+    for (int t = 0; t < partial->timeSteps && t < stats->timeSteps; t++) {
+        for (int i = 0; i < k; i++) {
+            const StatsPoint* minimum = &partial->minima[(size_t)t * k + i];
+            const StatsPoint* maximum = &partial->maxima[(size_t)t * k + i];
+            if (minimum->x >= 0) offerHeap(stats->minima + (size_t)t * k, k, minimum, true);
+            if (maximum->x >= 0) offerHeap(stats->maxima + (size_t)t * k, k, maximum, false);
+        }
+        const long long* from = partial->counts + (size_t)t * partial->countsPerStep;
+        long long* to = stats->counts + (size_t)t * stats->countsPerStep;
+        for (int i = 0; i < stats->countsPerStep; i++) to[i] += from[i];
+    }
+}
+
+// Merge k best-first entries of a and b into out (k entries, best first)
+static void mergeLists(const StatsPoint* a, const StatsPoint* b, StatsPoint* out, int k, bool minima) {
+    int i = 0, j = 0;
+    for (int n = 0; n < k; n++) {
+        out[n] = ranksAbove(&b[j], &a[i], minima) ? b[j++] : a[i++];
+    }
+}
+
+// Records are one timestep each: topK minima then topK maxima, best first. The list
+// length comes from the record size, so any K works with the one operation.
+static void combineTopK(void* in, void* inout, int* len, MPI_Datatype* type) {
+    int recordBytes;
+    MPI_Type_size(*type, &recordBytes);
+    const int k = recordBytes / (int)(2 * sizeof(StatsPoint));
+
+    StatsPoint* merged = (StatsPoint*)malloc(2 * k * sizeof(StatsPoint));
+    if (!merged) {
+        printf("Error: Failed to allocate the top-k merge buffer\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return;
+    }
+    const StatsPoint* a = (const StatsPoint*)in;
+    StatsPoint* b = (StatsPoint*)inout;
+    for (int i = 0; i < *len; i++, a += 2 * k, b += 2 * k) {
+        mergeLists(a, b, merged, k, true);
+        mergeLists(a + k, b + k, merged + k, k, false);
+        memcpy(b, merged, 2 * k * sizeof(StatsPoint));
+    }
+    free(merged);
+}
+
+static MPI_Op topKOp = MPI_OP_NULL;
+
+static void writePoints(FILE* fp, const char* name, const StatsPoint* points, int k) {
+    fprintf(fp, "\"%s\": [", name);
+    for (int i = 0, written = 0; i < k; i++) {
+        if (points[i].x < 0) continue;
+        fprintf(fp, "%s{\"value\": %.9g, \"x\": %.0f, \"y\": %.0f, \"z\": %.0f}", written++ ? ", " : "",
+                points[i].value, points[i].x, points[i].y, points[i].z);
+    }
+    fprintf(fp, "]");
+}
+
+static void writeStats(const char* path, const ExtendedStats* stats, const StatsPoint* lists,
+                       const long long* counts, int timeSteps, int size) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        printf("Error: Cannot create %s\n", path);
+        return;
+    }
+
+    const int k = stats->topK;
+    fprintf(fp, "{\n  \"ranks\": %d,\n  \"top_k\": %d,\n  \"thresholds\": [", size, k);
+    for (int i = 0; i < stats->thresholdCount; i++) {
+        fprintf(fp, "%s%.9g", i ? ", " : "", stats->thresholds[i]);
+    }
+    fprintf(fp, "],\n  \"histogram\": {\"bins\": %d, \"low\": %.9g, \"high\": %.9g},\n  \"timesteps\": [",
+            stats->bins, stats->low, stats->high);
+
+    // Timesteps no rank analysed (an incremental run's stored range) are left out
+    for (int t = 0, written = 0; t < timeSteps; t++) {
+        const long long* c = counts + (size_t)t * stats->countsPerStep;
+        if (c[0] == 0) continue;
+
+        fprintf(fp, "%s\n    {\"t\": %d, \"voxels\": %lld", written++ ? "," : "", t, c[0]);
+        if (k > 0) {
+            fprintf(fp, ", ");
+            writePoints(fp, "minima", lists + (size_t)t * 2 * k, k);
+            fprintf(fp, ", ");
+            writePoints(fp, "maxima", lists + (size_t)t * 2 * k + k, k);
+        }
+        if (stats->thresholdCount > 0) {
+            fprintf(fp, ", \"above\": [");
+            for (int i = 0; i < stats->thresholdCount; i++) fprintf(fp, "%s%lld", i ? ", " : "", c[1 + i]);
+            fprintf(fp, "]");
+        }
+        if (stats->bins > 0) {
+            const long long* histogram = c + 1 + stats->thresholdCount;
+            fprintf(fp, ", \"under\": %lld, \"bins\": [", histogram[0]);
+            for (int i = 1; i <= stats->bins; i++) fprintf(fp, "%s%lld", i > 1 ? ", " : "", histogram[i]);
+            fprintf(fp, "], \"over\": %lld", histogram[stats->bins + 1]);
+        }
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+}
+
+void statsReport(const ProgramArgs* args, MPI_Comm comm) {
+    if (!statsRequested(args)) return;
+
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Every rank covers the whole run, analysed or not, so the buffers line up
+    ProgramArgs whole = *args;
+    whole.stepOffset = 0;
+    ExtendedStats* stats = statsFor(&whole);
+    int ok = stats != NULL;
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!ok) {
+        if (rank == 0) printf("Error: statistics unavailable, %s.stats.json not written\n", args->outputFile);
+        return;
+    }
+
+    const int timeSteps = args->timeSteps;
+    const int k = stats->topK;
+    const size_t countValues = (size_t)timeSteps * stats->countsPerStep;
+    const size_t listPoints = (size_t)timeSteps * 2 * k;
+
+    // Lists sorted best first, as the operation expects them
+    StatsPoint* lists = (StatsPoint*)malloc((listPoints > 0 ? listPoints : 1) * sizeof(StatsPoint));
+    StatsPoint* globalLists = rank == 0 ? (StatsPoint*)malloc((listPoints > 0 ? listPoints : 1) * sizeof(StatsPoint)) : NULL;
+    long long* globalCounts = rank == 0 ? (long long*)malloc((countValues + 1) * sizeof(long long)) : NULL;
+    if (!lists || (rank == 0 && (!globalLists || !globalCounts))) {
+        printf("Rank %d: Failed to allocate the statistics buffers\n", rank);
+        MPI_Abort(comm, 1);
+    }
+    for (int t = 0; t < timeSteps; t++) {
+        StatsPoint* record = lists + (size_t)t * 2 * k;
+        memcpy(record, stats->minima + (size_t)t * k, k * sizeof(StatsPoint));
+        memcpy(record + k, stats->maxima + (size_t)t * k, k * sizeof(StatsPoint));
+        qsort(record, k, sizeof(StatsPoint), compareMinima);
+        qsort(record + k, k, sizeof(StatsPoint), compareMaxima);
+    }
+
+    profileBegin(PROFILE_REDUCE);
+    MPI_Reduce(stats->counts, globalCounts, (int)countValues, MPI_LONG_LONG, MPI_SUM, 0, comm);
+    if (k > 0) {
+        MPI_Datatype recordType;
+        MPI_Type_contiguous(2 * k * POINT_FIELDS, MPI_DOUBLE, &recordType);
+        MPI_Type_commit(&recordType);
+        if (topKOp == MPI_OP_NULL) MPI_Op_create(combineTopK, 1, &topKOp);
+        MPI_Reduce(lists, globalLists, timeSteps, recordType, topKOp, 0, comm);
+        MPI_Type_free(&recordType);
+    }
+    profileEnd(PROFILE_REDUCE, countValues * sizeof(long long) + listPoints * sizeof(StatsPoint));
+
+    if (rank == 0) {
+        char path[300];
+        snprintf(path, sizeof(path), "%s.stats.json", args->outputFile);
+        writeStats(path, stats, globalLists, globalCounts, timeSteps, size);
+        printf("Statistics written to %s\n", path);
+    }
+
+    free(lists);
+    free(globalLists);
+    free(globalCounts);
+    statsFree(accumulator);
+    accumulator = NULL;
+}
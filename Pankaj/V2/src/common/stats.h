@@ -0,0 +1,79 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include "mpi.h"
+#include "timeseries.h"
+
+// Extended statistics behind --top-k, --threshold and --histogram, gathered by the same
+// sweep that fills TimeSeriesResults (analyzeLocalData / analyzeLocalBox), so the block is
+// read and visited once:
+//   top-k      the K lowest local minima and K highest local maxima of each timestep with
+//              their global (x, y, z); ties go to the lower z, then y, then x
+//   threshold  per timestep, how many owned voxels are greater than each threshold
+//   histogram  per timestep, voxel counts in BINS equal bins over [LO, HI) plus under/overflow
+// Each rank keeps per-timestep heaps and counters; statsReport merges them across ranks
+// (top-k lists through a user-defined MPI_Op) and rank 0 writes "<outputFile>.stats.json".
+
+// One entry of a top-k list, all doubles so a timestep's lists travel as one MPI_DOUBLE run
+typedef struct {
+    double value;
+    double x, y, z;           // global coordinates, x < 0 for an empty slot
+} StatsPoint;
+
+typedef struct {
+    int timeSteps;            // timesteps held (global timestep numbers)
+    int topK;
+    int thresholdCount;
+    double thresholds[STATS_MAX_THRESHOLDS];
+    int bins;                 // 0 = no histogram
+    double low, high;
+    int countsPerStep;        // voxels, thresholdCount counts, then under, bins, over (bins > 0)
+    StatsPoint* minima;       // timeSteps * topK heaps, the worst kept entry at the root
+    StatsPoint* maxima;
+    long long* counts;        // timeSteps * countsPerStep
+} ExtendedStats;
+
+// Whether args asks for any extended statistic
+static inline bool statsRequested(const ProgramArgs* args) {
+    return args->topK > 0 || args->thresholdCount > 0 || args->histogramBins > 0;
+}
+
+// Empty statistics configured from args for global timesteps [0, timeSteps) (NULL on failure)
+ExtendedStats* statsCreate(const ProgramArgs* args, int timeSteps);
+void statsFree(ExtendedStats* stats);
+
+// This process's accumulator, grown to cover the block args describes (timesteps
+// args->stepOffset onwards); NULL when no statistic is requested or memory runs out
+ExtendedStats* statsFor(const ProgramArgs* args);
+
+// Offer a local minimum (maximum) of global timestep t at global (x, y, z)
+void statsOfferMinimum(ExtendedStats* stats, int t, double value, int x, int y, int z);
+void statsOfferMaximum(ExtendedStats* stats, int t, double value, int x, int y, int z);
+
+// Count one owned voxel of global timestep t
+static inline void statsAddValue(ExtendedStats* stats, int t, double value) {
+    long long* counts = stats->counts + (size_t)t * stats->countsPerStep;
+    counts[0]++;
+    for (int i = 0; i < stats->thresholdCount; i++) {
+        counts[1 + i] += value > stats->thresholds[i];
+    }
+    if (stats->bins > 0) {
+        long long* histogram = counts + 1 + stats->thresholdCount;
+        int bin;
+        if (!(value >= stats->low)) bin = 0;
+        else if (value >= stats->high) bin = stats->bins + 1;
+        else bin = 1 + (int)((value - stats->low) / (stats->high - stats->low) * stats->bins);
+        if (bin > stats->bins) bin = stats->bins;
+        histogram[bin]++;
+    }
+}
+
+// Fold partial statistics (another thread) of the same configuration into stats
+void statsMerge(ExtendedStats* stats, const ExtendedStats* partial);
+
+// Collective over comm, no-op unless args requests statistics: merge every rank's
+// accumulator, write "<outputFile>.stats.json" on rank 0 and start the accumulator afresh
+void statsReport(const ProgramArgs* args, MPI_Comm comm);
+
+#endif // STATS_H
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "stream.h"
+#include "profile.h"
+
+// Default per-buffer budget when --window is not given
+#define STREAM_BUFFER_BYTES (64L << 20)
+
+int streamWindowSize(const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm) {
+    long window = args->window;
+    if (window <= 0) {
+        long pointBytes = (long)subdomain->tempWidth * subdomain->tempHeight * subdomain->tempDepth * sizeof(float);
+        window = STREAM_BUFFER_BYTES / pointBytes;
+
+        // Every rank must post the same number of collective reads: the largest block decides
+        MPI_Allreduce(MPI_IN_PLACE, &window, 1, MPI_LONG, MPI_MIN, comm);
+    }
+    if (window < 1) window = 1;
+    if (window > args->timeSteps) window = args->timeSteps;
+    return (int)window;
+}
+
+// Post the collective read of the next window into buffer b (nothing left: mark it empty)
+static void postWindow(TimeWindowReader* reader, int b) {
+    reader->request[b] = MPI_REQUEST_NULL;
+    if (reader->filetype[b] != MPI_DATATYPE_NULL) MPI_Type_free(&reader->filetype[b]);
+
+    if (reader->nextStart >= reader->timeSteps) {
+        reader->count[b] = 0;
+        return;
+    }
+
+    const SubDomain* subdomain = &reader->subdomain;
+    int count = reader->timeSteps - reader->nextStart;
+    if (count > reader->window) count = reader->window;
+
+    int globalSizes[4] = {reader->nZ, reader->nY, reader->nX, reader->timeSteps};
+    int subSizes[4] = {subdomain->tempDepth, subdomain->tempHeight, subdomain->tempWidth, count};
+    int starts[4] = {subdomain->tempStartZ, subdomain->tempStartY, subdomain->tempStartX, reader->nextStart};
+
+    MPI_Type_create_subarray(4, globalSizes, subSizes, starts, MPI_ORDER_C, MPI_FLOAT, &reader->filetype[b]);
+    MPI_Type_commit(&reader->filetype[b]);
+    MPI_File_set_view(reader->fh[b], 0, MPI_FLOAT, reader->filetype[b], "native", MPI_INFO_NULL);
+
+    MPI_File_iread_all(reader->fh[b], reader->buffer[b], (int)(reader->volume * count), MPI_FLOAT,
+                       &reader->request[b]);
+
+    reader->start[b] = reader->nextStart;
+    reader->count[b] = count;
+    reader->nextStart += count;
+}
+
+bool streamOpen(TimeWindowReader* reader, const char* inputFile, const SubDomain* subdomain,
+                const ProgramArgs* args, int window, int firstStep, MPI_Comm comm) {
+    reader->subdomain = *subdomain;
+    reader->window = window;
+    reader->timeSteps = args->timeSteps;
+    reader->nX = args->nX;
+    reader->nY = args->nY;
+    reader->nZ = args->nZ;
+    reader->volume = (long)subdomain->tempWidth * subdomain->tempHeight * subdomain->tempDepth;
+    reader->current = 1;
+    reader->nextStart = firstStep;
+
+    for (int b = 0; b < 2; b++) {
+        reader->fh[b] = MPI_FILE_NULL;
+        reader->filetype[b] = MPI_DATATYPE_NULL;
+        reader->request[b] = MPI_REQUEST_NULL;
+        reader->count[b] = 0;
+        reader->buffer[b] = (float*)malloc(reader->volume * window * sizeof(float));
+    }
+    if (!reader->buffer[0] || !reader->buffer[1]) {
+        printf("Failed to allocate memory for the time window buffers\n");
+        streamClose(reader);
+        return false;
+    }
+
+    for (int b = 0; b < 2; b++) {
+        int ret = MPI_File_open(comm, inputFile, MPI_MODE_RDONLY, MPI_INFO_NULL, &reader->fh[b]);
+        if (ret != MPI_SUCCESS) {
+            char error_string[MPI_MAX_ERROR_STRING];
+            int length_of_error_string;
+            MPI_Error_string(ret, error_string, &length_of_error_string);
+            printf("Error opening file: %s\n", error_string);
+            reader->fh[b] = MPI_FILE_NULL;
+            streamClose(reader);
+            return false;
+        }
+    }
+
+    postWindow(reader, 0);
+    return true;
+}
+
+float* streamNext(TimeWindowReader* reader, int* start, int* count) {
+    // Hand out the buffer whose read is in flight; the buffer the caller has just
+    // finished with receives the window after it
+    const int b = reader->current ^ 1;
+
+    MPI_Status status;
+    profileBegin(PROFILE_READ);
+    MPI_Wait(&reader->request[b], &status);
+    profileEnd(PROFILE_READ, (double)reader->volume * reader->count[b] * sizeof(float));
+
+    if (reader->count[b] == 0) return NULL;
+
+    int received;
+    MPI_Get_count(&status, MPI_FLOAT, &received);
+    if (received != reader->volume * reader->count[b]) {
+        printf("Error: Read %d elements, expected %ld\n", received, reader->volume * reader->count[b]);
+    }
+
+    postWindow(reader, reader->current);
+    reader->current = b;
+
+    *start = reader->start[b];
+    *count = reader->count[b];
+    return reader->buffer[b];
+}
+
+void streamClose(TimeWindowReader* reader) {
+    for (int b = 0; b < 2; b++) {
+        if (reader->request[b] != MPI_REQUEST_NULL) MPI_Wait(&reader->request[b], MPI_STATUS_IGNORE);
+        if (reader->filetype[b] != MPI_DATATYPE_NULL) MPI_Type_free(&reader->filetype[b]);
+        if (reader->fh[b] != MPI_FILE_NULL) MPI_File_close(&reader->fh[b]);
+        free(reader->buffer[b]);
+        reader->buffer[b] = NULL;
+    }
+}
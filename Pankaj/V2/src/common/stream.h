@@ -0,0 +1,43 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "mpi.h"
+#include "timeseries.h"
+
+// Reads the padded block one window of timesteps at a time, [z][y][x][t0:t0+count),
+// with the next window's MPI_File_iread_all in flight while the current one is analysed.
+// Each of the two buffers has its own file handle so its view can change while the
+// other handle still has a read pending.
+typedef struct {
+    MPI_File fh[2];
+    float* buffer[2];
+    MPI_Request request[2];
+    MPI_Datatype filetype[2];
+    int start[2];                  // first timestep held by each buffer
+    int count[2];                  // timesteps held by each buffer (0 = unused)
+    int current;                   // buffer handed out by the last streamNext
+    int nextStart;                 // first timestep not yet requested
+    int window;
+    int timeSteps;
+    long volume;                   // padded points per timestep
+    int nX, nY, nZ;
+    SubDomain subdomain;
+} TimeWindowReader;
+
+// Timesteps per window: --window if given, otherwise as many as fit in 64 MiB per buffer
+// of the largest block. Collective over comm, so every rank gets the same window.
+int streamWindowSize(const SubDomain* subdomain, const ProgramArgs* args, MPI_Comm comm);
+
+// Open the file twice, allocate both window buffers and post the first read. Windows
+// cover timesteps [firstStep, timeSteps); none are read if firstStep >= timeSteps.
+bool streamOpen(TimeWindowReader* reader, const char* inputFile, const SubDomain* subdomain,
+                const ProgramArgs* args, int window, int firstStep, MPI_Comm comm);
+
+// Wait for the next window and start reading the one after it. Returns the point-major
+// block [tempDepth][tempHeight][tempWidth][count] (valid until the following call) and
+// its first timestep, or NULL once every timestep has been handed out.
+float* streamNext(TimeWindowReader* reader, int* start, int* count);
+
+void streamClose(TimeWindowReader* reader);
+
+#endif // STREAM_H
@@ -0,0 +1,676 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include "timeseries.h"
+#include "chunked.h"
+#include "profile.h"
+#include "device.h"
+#include "stats.h"
+#include "placement.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Allocate memory for results structure
+TimeSeriesResults* allocateResults(int timeSteps) {
+    TimeSeriesResults* results = (TimeSeriesResults*)malloc(sizeof(TimeSeriesResults));
+    if (!results) return NULL;
+
+    results->minimaCount = (int*)calloc(timeSteps, sizeof(int));
+    results->maximaCount = (int*)calloc(timeSteps, sizeof(int));
+    results->minValues = (double*)malloc(timeSteps * sizeof(double));
+    results->maxValues = (double*)malloc(timeSteps * sizeof(double));
+
+    // Initialize min/max values
+    for (int t = 0; t < timeSteps; t++) {
+        results->minValues[t] = DBL_MAX;
+        results->maxValues[t] = -DBL_MAX;
+    }
+
+    return results;
+}
+
+// Free memory for results structure
+void freeResults(TimeSeriesResults* results) {
+    if (!results) return;
+
+    free(results->minimaCount);
+    free(results->maximaCount);
+    free(results->minValues);
+    free(results->maxValues);
+    free(results);
+}
+
+// Return the value of "--name=value" if arg is that option, NULL otherwise
+static const char* optionValue(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, length) != 0 || arg[2 + length] != '=') {
+        return NULL;
+    }
+    return arg + 3 + length;
+}
+
+// Parse one optional flag; returns false for unknown flags or values
+static bool parseOption(const char* arg, ProgramArgs* args) {
+    const char* value;
+
+    if ((value = optionValue(arg, "layout"))) {
+        if (strcmp(value, "point") == 0) args->layout = LAYOUT_POINT_MAJOR;
+        else if (strcmp(value, "time") == 0) args->layout = LAYOUT_TIME_MAJOR;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "threads"))) {
+        args->threads = atoi(value);
+        return args->threads >= 0;
+    }
+
+    if ((value = optionValue(arg, "overlap"))) {
+        if (strcmp(value, "0") == 0) args->overlap = false;
+        else if (strcmp(value, "1") == 0) args->overlap = true;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "window"))) {
+        args->window = atoi(value);
+        return args->window >= 0;
+    }
+
+    if ((value = optionValue(arg, "pipeline"))) {
+        args->pipeline = atoi(value);
+        return args->pipeline >= 0;
+    }
+
+    if ((value = optionValue(arg, "distribute"))) {
+        if (strcmp(value, "flat") == 0) args->distribute = DISTRIBUTE_FLAT;
+        else if (strcmp(value, "node") == 0) args->distribute = DISTRIBUTE_NODE;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "reduce"))) {
+        if (strcmp(value, "blocking") == 0) args->reduceOverlap = false;
+        else if (strcmp(value, "overlap") == 0) args->reduceOverlap = true;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "memory-limit"))) {
+        char* end;
+        double bytes = strtod(value, &end);
+        if (end == value || bytes < 0) return false;
+        if (*end == 'K' || *end == 'k') bytes *= 1024.0, end++;
+        else if (*end == 'M' || *end == 'm') bytes *= 1024.0 * 1024.0, end++;
+        else if (*end == 'G' || *end == 'g') bytes *= 1024.0 * 1024.0 * 1024.0, end++;
+        args->memoryLimit = (long)bytes;
+        return *end == '\0';
+    }
+
+    if ((value = optionValue(arg, "device"))) {
+        if (strcmp(value, "cpu") == 0) args->device = DEVICE_CPU;
+        else if (strcmp(value, "gpu") == 0) args->device = DEVICE_GPU;
+        else if (strcmp(value, "offload") == 0) args->device = DEVICE_OFFLOAD;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "top-k"))) {
+        args->topK = atoi(value);
+        return args->topK >= 0 && args->topK <= 1024;
+    }
+
+    if ((value = optionValue(arg, "threshold"))) {
+        char* end;
+        args->thresholdCount = 0;
+        for (;;) {
+            if (args->thresholdCount == STATS_MAX_THRESHOLDS) return false;
+            args->thresholds[args->thresholdCount++] = strtod(value, &end);
+            if (end == value) return false;
+            if (*end != ',') return *end == '\0';
+            value = end + 1;
+        }
+    }
+
+    if ((value = optionValue(arg, "histogram"))) {
+        char* end;
+        args->histogramBins = (int)strtol(value, &end, 10);
+        if (*end != ':') return false;
+        args->histogramLow = strtod(end + 1, &end);
+        if (*end != ':') return false;
+        args->histogramHigh = strtod(end + 1, &end);
+        return *end == '\0' && args->histogramBins > 0 && args->histogramHigh > args->histogramLow;
+    }
+
+    if ((value = optionValue(arg, "placement"))) {
+        if (strcmp(value, "rank") == 0) args->placement = PLACEMENT_RANK;
+        else if (strcmp(value, "socket") == 0) args->placement = PLACEMENT_SOCKET;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "bind-report"))) {
+        if (strcmp(value, "0") == 0) args->bindReport = false;
+        else if (strcmp(value, "1") == 0) args->bindReport = true;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "io-strategy"))) {
+        if (strcmp(value, "auto") == 0) args->ioStrategy = IO_AUTO;
+        else if (strcmp(value, "level0") == 0) args->ioStrategy = IO_INDEPENDENT_ROWS;
+        else if (strcmp(value, "level1") == 0) args->ioStrategy = IO_COLLECTIVE_ROWS;
+        else if (strcmp(value, "level2") == 0) args->ioStrategy = IO_INDEPENDENT_SUBARRAY;
+        else if (strcmp(value, "level3") == 0) args->ioStrategy = IO_COLLECTIVE_SUBARRAY;
+        else if (strcmp(value, "isend") == 0) args->ioStrategy = IO_ROOT_ISEND;
+        else if (strcmp(value, "bsend") == 0) args->ioStrategy = IO_ROOT_BSEND;
+        else return false;
+        return true;
+    }
+
+    if ((value = optionValue(arg, "io-calibration"))) {
+        snprintf(args->ioCalibration, sizeof(args->ioCalibration), "%s", value);
+        return true;
+    }
+
+    if ((value = optionValue(arg, "io-hints"))) {
+        snprintf(args->ioHints, sizeof(args->ioHints), "%s", value);
+        return true;
+    }
+
+    if ((value = optionValue(arg, "kernel"))) {
+        if (strcmp(value, "scalar") == 0) args->kernel = KERNEL_SCALAR;
+        else if (strcmp(value, "fused") == 0) args->kernel = KERNEL_FUSED;
+        else if (strcmp(value, "simd") == 0) args->kernel = KERNEL_SIMD;
+        else if (strcmp(value, "early") == 0) args->kernel = KERNEL_EARLY;
+        else return false;
+        return true;
+    }
+
+    return false;
+}
+
+// Ghost cells of the largest block: one face per split dimension on each side
+static double ghostSurface(int pX, int pY, int pZ, int nX, int nY, int nZ) {
+    double sx = (nX + pX - 1) / pX;
+    double sy = (nY + pY - 1) / pY;
+    double sz = (nZ + pZ - 1) / pZ;
+    return (pX > 1 ? 2 : 0) * sy * sz + (pY > 1 ? 2 : 0) * sx * sz + (pZ > 1 ? 2 : 0) * sx * sy;
+}
+
+// Fill the zero entries of pX/pY/pZ with the factorization of size that has the smallest
+// ghost surface per owned volume; non-zero entries are kept. False if nothing fits.
+static bool chooseProcessGrid(ProgramArgs* args, int size) {
+    const double volume = (double)args->nX * args->nY * args->nZ / size;
+    double bestCost = -1.0;
+    int best[3] = {0, 0, 0};
+
+    for (int px = 1; px <= size; px++) {
+        if (size % px != 0 || (args->pX && px != args->pX) || px > args->nX) continue;
+        for (int py = 1; py <= size / px; py++) {
+            if ((size / px) % py != 0 || (args->pY && py != args->pY) || py > args->nY) continue;
+            int pz = size / px / py;
+            if ((args->pZ && pz != args->pZ) || pz > args->nZ) continue;
+
+            double cost = ghostSurface(px, py, pz, args->nX, args->nY, args->nZ) / volume;
+            if (bestCost < 0.0 || cost < bestCost) {
+                bestCost = cost;
+                best[0] = px;
+                best[1] = py;
+                best[2] = pz;
+            }
+        }
+    }
+
+    if (bestCost < 0.0) return false;
+    args->pX = best[0];
+    args->pY = best[1];
+    args->pZ = best[2];
+    return true;
+}
+
+// Parse command line arguments; chunkedInput is set for readers of the chunked format
+static bool parseArgumentsFor(int argc, char** argv, int rank, int size, ProgramArgs* args, bool chunkedInput) {
+    // Check for correct number of arguments
+    if (argc < 10) {
+        if (rank == 0) {
+            printf("Usage: %s <inputFile> <pX> <pY> <pZ> <nX> <nY> <nZ> <timeSteps> <outputFile> [options]\n", argv[0]);
+            printf("  pX, pY or pZ = 0 picks that factor automatically (least ghost surface per volume)\n");
+            printf("  nX nY nZ timeSteps = 0 0 0 0 reads them from a chunked file's header (chunkedIO)\n");
+            printf("Options:\n");
+            printf("  --layout=point|time   local block layout used by the kernel (default: point)\n");
+            printf("  --kernel=scalar|fused|simd|early\n");
+            printf("                        extrema kernel; simd implies --layout=time, early suits smooth data\n");
+            printf("                        (default: fused)\n");
+            printf("  --overlap=0|1         halo exchange: sweep the interior while faces arrive (default: 1)\n");
+            printf("  --window=N            streaming mode: timesteps per read window (default: 64 MiB buffers)\n");
+            printf("  --pipeline=N          *IO_derData: read N z-slabs while analysing the previous one (default: 0, off)\n");
+            printf("  --distribute=flat|node\n");
+            printf("                        send/isend/bsend: root sends per rank or per node shared window (default: flat)\n");
+            printf("  --io-strategy=auto|level0|level1|level2|level3|isend|bsend\n");
+            printf("                        independentIO_derData_and_isend: how blocks are read (default: auto)\n");
+            printf("  --io-calibration=FILE benchmark_results.csv consulted by --io-strategy=auto\n");
+            printf("  --io-hints=FILE       key=value MPI-IO hints for collective reads (also TS_MPIIO_HINTS)\n");
+            printf("  --reduce=blocking|overlap\n");
+            printf("                        service: finish a job's reduction while the next job reads (default: blocking)\n");
+            printf("  --memory-limit=BYTES[K|M|G]\n");
+            printf("                        outOfCoreIO: slab buffer per rank (default: 256M)\n");
+            printf("  --threads=N           compute threads per rank in OpenMP builds (default: OMP_NUM_THREADS)\n");
+            printf("  --device=cpu|gpu|offload\n");
+            printf("                        extrema sweep on the CPU, a CUDA/HIP GPU or via OpenMP target (default: cpu);\n");
+            printf("                        gpu is experimental and untested on hardware\n");
+            printf("  --placement=rank|socket\n");
+            printf("                        process grid in rank order, or socket by socket for bound ranks (default: rank)\n");
+            printf("  --bind-report=0|1     print each rank's host, CPUs, socket and NUMA node (default: 0)\n");
+            printf("  --top-k=K             K lowest minima and highest maxima per timestep with coordinates\n");
+            printf("  --threshold=V[,V...]  voxels above each value per timestep (up to %d values)\n", STATS_MAX_THRESHOLDS);
+            printf("  --histogram=BINS:LO:HI\n");
+            printf("                        per-timestep histogram over [LO, HI) plus under/overflow\n");
+            printf("                        The three write <outputFile>.stats.json; they are gathered in the\n");
+            printf("                        point-major CPU sweep, which then stands in for --layout/--kernel/--device\n");
+        }
+        return false;
+    }
+
+    args->layout = LAYOUT_POINT_MAJOR;
+    args->kernel = KERNEL_FUSED;
+    args->threads = 0;
+    args->overlap = true;
+    args->window = 0;
+    args->pipeline = 0;
+    args->distribute = DISTRIBUTE_FLAT;
+    args->ioStrategy = IO_AUTO;
+    args->ioCalibration[0] = '\0';
+    args->ioHints[0] = '\0';
+    args->reduceOverlap = false;
+    args->memoryLimit = 0;
+    args->device = DEVICE_CPU;
+    args->topK = 0;
+    args->thresholdCount = 0;
+    args->histogramBins = 0;
+    args->histogramLow = 0.0;
+    args->histogramHigh = 0.0;
+    args->placement = PLACEMENT_RANK;
+    args->bindReport = false;
+    args->stepOffset = 0;
+    for (int i = 10; i < argc; i++) {
+        if (!parseOption(argv[i], args)) {
+            if (rank == 0) {
+                printf("Error: unknown option %s\n", argv[i]);
+            }
+            return false;
+        }
+    }
+
+    snprintf(args->inputFile, sizeof(args->inputFile), "%s", argv[1]);
+    args->pX = atoi(argv[2]);
+    args->pY = atoi(argv[3]);
+    args->pZ = atoi(argv[4]);
+    args->nX = atoi(argv[5]);
+    args->nY = atoi(argv[6]);
+    args->nZ = atoi(argv[7]);
+    args->timeSteps = atoi(argv[8]);
+    snprintf(args->outputFile, sizeof(args->outputFile), "%s", argv[9]);
+
+    // The raw readers would take a chunked file's header and index for samples
+    ChunkedHeader header;
+    const bool chunked = readChunkedHeader(args->inputFile, &header);
+    if (chunked && !chunkedInput) {
+        if (rank == 0) {
+            printf("Error: %s is a chunked file, use chunkedIO\n", args->inputFile);
+        }
+        return false;
+    }
+
+    // Chunked files describe themselves: 0 0 0 0 takes the dimensions from the header
+    if (args->nX == 0 && args->nY == 0 && args->nZ == 0 && args->timeSteps == 0) {
+        if (!chunked) {
+            if (rank == 0) {
+                printf("Error: dimensions 0 0 0 0 need a chunked input file and chunkedIO\n");
+            }
+            return false;
+        }
+        args->nX = header.nX;
+        args->nY = header.nY;
+        args->nZ = header.nZ;
+        args->timeSteps = header.timeSteps;
+    }
+
+    // A 0 in pX/pY/pZ asks for that factor to be chosen from the communicator size
+    if (args->pX == 0 || args->pY == 0 || args->pZ == 0) {
+        if (!chooseProcessGrid(args, size)) {
+            if (rank == 0) {
+                printf("Error: no process grid with the given factors fits %d processes\n", size);
+            }
+            return false;
+        }
+        if (rank == 0) {
+            printf("Process grid: %d x %d x %d (automatic)\n", args->pX, args->pY, args->pZ);
+        }
+    }
+
+    // Verify process grid matches total number of processes
+    if (args->pX * args->pY * args->pZ != size) {
+        if (rank == 0) {
+            printf("Error: pX*pY*pZ (%d) must equal the total number of processes (%d)\n",
+                   args->pX * args->pY * args->pZ, size);
+        }
+        return false;
+    }
+
+    // Every rank must own at least one cell in each dimension
+    if (args->pX > args->nX || args->pY > args->nY || args->pZ > args->nZ) {
+        if (rank == 0) {
+            printf("Error: process grid %d x %d x %d is finer than the %d x %d x %d domain\n",
+                   args->pX, args->pY, args->pZ, args->nX, args->nY, args->nZ);
+        }
+        return false;
+    }
+
+    // A rank's padded block goes to MPI as one int count; the largest block has
+    // ceil(n / p) cells plus a ghost layer on each side in every dimension
+    const int n[3] = {args->nX, args->nY, args->nZ};
+    const int p[3] = {args->pX, args->pY, args->pZ};
+    long blockValues = args->timeSteps;
+    for (int d = 0; d < 3; d++) {
+        int extent = (n[d] + p[d] - 1) / p[d] + 2;
+        blockValues *= extent < n[d] ? extent : n[d];
+    }
+    if (blockValues > INT_MAX) {
+        if (rank == 0) {
+            printf("Error: process grid %d x %d x %d leaves blocks of up to %ld values, more than an MPI count "
+                   "holds; use more processes\n", args->pX, args->pY, args->pZ, blockValues);
+        }
+        return false;
+    }
+
+    // An accelerator that is not there leaves the run on the CPU kernels
+    if (args->device != DEVICE_CPU) {
+        const char* note = NULL;
+        bool available = deviceInit(args->device, rank, &note);
+        if (rank == 0 && !available) {
+            printf("Warning: --device=%s unavailable (%s), using the CPU kernels\n", deviceName(args->device), note);
+        } else if (rank == 0 && note) {
+            printf("Device %s: %s\n", deviceName(args->device), note);
+        }
+        if (!available) args->device = DEVICE_CPU;
+    }
+
+    // Grid order, binding report and first-touch threads; collective when either flag is given
+    return placementInit(args, MPI_COMM_WORLD);
+}
+
+bool parseArguments(int argc, char** argv, int rank, int size, ProgramArgs* args) {
+    return parseArgumentsFor(argc, argv, rank, size, args, false);
+}
+
+bool parseChunkedArguments(int argc, char** argv, int rank, int size, ProgramArgs* args) {
+    return parseArgumentsFor(argc, argv, rank, size, args, true);
+}
+
+// Inclusive [start, end] of block pos when n cells are split into p nearly equal blocks
+static void partitionRange(int n, int p, int pos, int* start, int* end) {
+    const int base = n / p;
+    const int remainder = n % p;
+    *start = pos * base + (pos < remainder ? pos : remainder);
+    *end = *start + base + (pos < remainder ? 1 : 0) - 1;
+}
+
+// Calculate subdomain boundaries including ghost zones
+void calculateSubDomainBoundaries(int rank, int pX, int pY, int pZ, int nX, int nY, int nZ, SubDomain* subdomain) {
+    // Calculate process position in the 3D process grid
+    const int index = placementGridIndex(rank);
+    int posZ = index / (pX * pY);
+    int posY = (index % (pX * pY)) / pX;
+    int posX = index % pX;
+
+    // Balanced blocks: the first (n % p) positions get one extra cell
+    partitionRange(nX, pX, posX, &subdomain->startX, &subdomain->endX);
+    partitionRange(nY, pY, posY, &subdomain->startY, &subdomain->endY);
+    partitionRange(nZ, pZ, posZ, &subdomain->startZ, &subdomain->endZ);
+
+    // Calculate boundaries including ghost zones
+    subdomain->tempStartX = (subdomain->startX > 0) ? subdomain->startX - 1 : subdomain->startX;
+    subdomain->tempStartY = (subdomain->startY > 0) ? subdomain->startY - 1 : subdomain->startY;
+    subdomain->tempStartZ = (subdomain->startZ > 0) ? subdomain->startZ - 1 : subdomain->startZ;
+
+    subdomain->tempEndX = (subdomain->endX < nX - 1) ? subdomain->endX + 1 : subdomain->endX;
+    subdomain->tempEndY = (subdomain->endY < nY - 1) ? subdomain->endY + 1 : subdomain->endY;
+    subdomain->tempEndZ = (subdomain->endZ < nZ - 1) ? subdomain->endZ + 1 : subdomain->endZ;
+
+    // Calculate dimensions
+    subdomain->width = subdomain->endX - subdomain->startX + 1;
+    subdomain->height = subdomain->endY - subdomain->startY + 1;
+    subdomain->depth = subdomain->endZ - subdomain->startZ + 1;
+
+    subdomain->tempWidth = subdomain->tempEndX - subdomain->tempStartX + 1;
+    subdomain->tempHeight = subdomain->tempEndY - subdomain->tempStartY + 1;
+    subdomain->tempDepth = subdomain->tempEndZ - subdomain->tempStartZ + 1;
+}
+
+// Owned points whose six neighbours all lie inside the padded block
+LocalBox interiorBox(const SubDomain* subdomain) {
+    LocalBox box = ownedBox(subdomain);
+    if (box.x0 < 1) box.x0 = 1;
+    if (box.y0 < 1) box.y0 = 1;
+    if (box.z0 < 1) box.z0 = 1;
+    if (box.x1 > subdomain->tempWidth - 1) box.x1 = subdomain->tempWidth - 1;
+    if (box.y1 > subdomain->tempHeight - 1) box.y1 = subdomain->tempHeight - 1;
+    if (box.z1 > subdomain->tempDepth - 1) box.z1 = subdomain->tempDepth - 1;
+    return box;
+}
+
+// Split outer minus inner into z slabs, then y slabs, then x slabs of the remaining core
+int splitShell(const LocalBox* outer, const LocalBox* inner, LocalBox shell[6]) {
+    LocalBox core = intersectBox(*inner, *outer);
+
+    int count = 0;
+    if (isEmptyBox(&core)) {
+        if (!isEmptyBox(outer)) shell[count++] = *outer;
+        return count;
+    }
+
+    LocalBox slab;
+    slab = *outer; slab.z1 = core.z0;                                 if (!isEmptyBox(&slab)) shell[count++] = slab;
+    slab = *outer; slab.z0 = core.z1;                                 if (!isEmptyBox(&slab)) shell[count++] = slab;
+    slab = *outer; slab.z0 = core.z0; slab.z1 = core.z1; slab.y1 = core.y0; if (!isEmptyBox(&slab)) shell[count++] = slab;
+    slab = *outer; slab.z0 = core.z0; slab.z1 = core.z1; slab.y0 = core.y1; if (!isEmptyBox(&slab)) shell[count++] = slab;
+    slab = core; slab.x0 = outer->x0; slab.x1 = core.x0;              if (!isEmptyBox(&slab)) shell[count++] = slab;
+    slab = core; slab.x0 = core.x1; slab.x1 = outer->x1;              if (!isEmptyBox(&slab)) shell[count++] = slab;
+    return count;
+}
+
+// Split box into at most count tiles: z slabs when there are enough planes, z x y tiles
+// otherwise. tilesY rounds down so tilesZ * tilesY never exceeds count.
+int splitTiles(const LocalBox* box, int count, LocalBox* tiles) {
+    const int depth = box->z1 - box->z0;
+    const int height = box->y1 - box->y0;
+    if (count < 1 || isEmptyBox(box)) return 0;
+
+    int tilesZ = count < depth ? count : depth;
+    int tilesY = count / tilesZ;
+    if (tilesY > height) tilesY = height;
+    if (!tiles) return tilesZ * tilesY;
+
+    int n = 0;
+    for (int iz = 0; iz < tilesZ; iz++) {
+        for (int iy = 0; iy < tilesY; iy++) {
+            LocalBox tile = *box;
+            tile.z0 = box->z0 + (int)((long)depth * iz / tilesZ);
+            tile.z1 = box->z0 + (int)((long)depth * (iz + 1) / tilesZ);
+            tile.y0 = box->y0 + (int)((long)height * iy / tilesY);
+            tile.y1 = box->y0 + (int)((long)height * (iy + 1) / tilesY);
+            tiles[n++] = tile;
+        }
+    }
+    return n;
+}
+
+// Fold partial results (another thread, tile or rank) into results
+void mergeResults(TimeSeriesResults* results, const TimeSeriesResults* partial, int timeSteps) {
+    for (int t = 0; t < timeSteps; t++) {
+        results->minimaCount[t] += partial->minimaCount[t];
+        results->maximaCount[t] += partial->maximaCount[t];
+        if (partial->minValues[t] < results->minValues[t]) results->minValues[t] = partial->minValues[t];
+        if (partial->maxValues[t] > results->maxValues[t]) results->maxValues[t] = partial->maxValues[t];
+    }
+}
+
+// Extrema kernels: one instantiation per element type
+#define KERNEL_REAL float
+#define KERNEL_NAME(base) base
+#define KERNEL_HAS_SIMD
+#include "extrema_kernel.h"
+#undef KERNEL_REAL
+#undef KERNEL_NAME
+#undef KERNEL_HAS_SIMD
+
+#define KERNEL_REAL double
+#define KERNEL_NAME(base) base##Double
+#include "extrema_kernel.h"
+#undef KERNEL_REAL
+#undef KERNEL_NAME
+
+// Reduce results onto rank 0
+// One record per timestep: {minimaCount, maximaCount, minValue, maxValue}. Counts are
+// carried as doubles, exact far beyond any grid size.
+#define RECORD_FIELDS 4
+
+static void combineRecords(void* in, void* inout, int* len, MPI_Datatype* type) {
+    (void)type;
+    const double* a = (const double*)in;
+    double* b = (double*)inout;
+    for (int i = 0; i < *len; i++, a += RECORD_FIELDS, b += RECORD_FIELDS) {
+        b[0] += a[0];
+        b[1] += a[1];
+        if (a[2] < b[2]) b[2] = a[2];
+        if (a[3] > b[3]) b[3] = a[3];
+    }
+}
+
+// The record type and its operation, created on first use. Reducing whole records keeps
+// each call of the operation seeing complete timesteps however MPI segments the buffer.
+static MPI_Datatype recordType = MPI_DATATYPE_NULL;
+static MPI_Op recordOp = MPI_OP_NULL;
+
+static void ensureRecordOp(void) {
+    if (recordType != MPI_DATATYPE_NULL) return;
+    MPI_Type_contiguous(RECORD_FIELDS, MPI_DOUBLE, &recordType);
+    MPI_Type_commit(&recordType);
+    MPI_Op_create(combineRecords, 1, &recordOp);
+}
+
+static double* packRecords(const TimeSeriesResults* results, int timeSteps) {
+    double* records = (double*)malloc((size_t)timeSteps * RECORD_FIELDS * sizeof(double));
+    if (!records) return NULL;
+    for (int t = 0; t < timeSteps; t++) {
+        records[RECORD_FIELDS * t] = results->minimaCount[t];
+        records[RECORD_FIELDS * t + 1] = results->maximaCount[t];
+        records[RECORD_FIELDS * t + 2] = results->minValues[t];
+        records[RECORD_FIELDS * t + 3] = results->maxValues[t];
+    }
+    return records;
+}
+
+static void unpackRecords(const double* records, TimeSeriesResults* results, int timeSteps) {
+    for (int t = 0; t < timeSteps; t++) {
+        results->minimaCount[t] = (int)records[RECORD_FIELDS * t];
+        results->maximaCount[t] = (int)records[RECORD_FIELDS * t + 1];
+        results->minValues[t] = records[RECORD_FIELDS * t + 2];
+        results->maxValues[t] = records[RECORD_FIELDS * t + 3];
+    }
+}
+
+void reduceResultsStart(const TimeSeriesResults* localResults, TimeSeriesResults* globalResults,
+                        int timeSteps, MPI_Comm comm, ResultsReduction* reduction) {
+    MPI_Comm_rank(comm, &reduction->rank);
+    ensureRecordOp();
+
+    reduction->globalResults = globalResults;
+    reduction->timeSteps = timeSteps;
+    reduction->send = packRecords(localResults, timeSteps);
+    reduction->recv = reduction->rank == 0 ?
+        (double*)malloc((size_t)timeSteps * RECORD_FIELDS * sizeof(double)) : NULL;
+    if (!reduction->send || (reduction->rank == 0 && !reduction->recv)) {
+        printf("Rank %d: Failed to allocate the reduction buffers\n", reduction->rank);
+        MPI_Abort(comm, 1);
+    }
+
+    profileBegin(PROFILE_REDUCE);
+    MPI_Ireduce(reduction->send, reduction->recv, timeSteps, recordType, recordOp, 0, comm, &reduction->request);
+    profileEnd(PROFILE_REDUCE, (double)timeSteps * RECORD_FIELDS * sizeof(double));
+}
+
+void reduceResultsFinish(ResultsReduction* reduction) {
+    profileBegin(PROFILE_REDUCE);
+    MPI_Wait(&reduction->request, MPI_STATUS_IGNORE);
+    profileEnd(PROFILE_REDUCE, 0);
+    if (reduction->rank == 0) unpackRecords(reduction->recv, reduction->globalResults, reduction->timeSteps);
+    free(reduction->send);
+    free(reduction->recv);
+    reduction->send = NULL;
+    reduction->recv = NULL;
+}
+
+void reduceResults(const TimeSeriesResults* localResults, TimeSeriesResults* globalResults,
+                   int timeSteps, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    ensureRecordOp();
+
+    double* send = packRecords(localResults, timeSteps);
+    double* recv = rank == 0 ? (double*)malloc((size_t)timeSteps * RECORD_FIELDS * sizeof(double)) : NULL;
+    if (!send || (rank == 0 && !recv)) {
+        printf("Rank %d: Failed to allocate the reduction buffers\n", rank);
+        MPI_Abort(comm, 1);
+    }
+
+    profileBegin(PROFILE_REDUCE);
+    MPI_Reduce(send, recv, timeSteps, recordType, recordOp, 0, comm);
+    profileEnd(PROFILE_REDUCE, (double)timeSteps * RECORD_FIELDS * sizeof(double));
+    if (rank == 0) unpackRecords(recv, globalResults, timeSteps);
+
+    free(send);
+    free(recv);
+}
+
+// Write results to output file
+void writeResults(const char* outputFile, const TimeSeriesResults* globalResults, int timeSteps, const TimingInfo* timing) {
+    profileBegin(PROFILE_WRITE);
+    FILE* fp = fopen(outputFile, "w");
+    if (!fp) {
+        printf("Error: Cannot open output file %s\n", outputFile);
+        profileEnd(PROFILE_WRITE, 0);
+        return;
+    }
+
+    // Line 1: Local minima and maxima counts
+    for (int t = 0; t < timeSteps; t++) {
+        fprintf(fp, "(%d, %d)", globalResults->minimaCount[t], globalResults->maximaCount[t]);
+        if (t < timeSteps - 1) {
+            fprintf(fp, ", ");
+        }
+    }
+    fprintf(fp, "\n");
+
+    // Line 2: Global minimum and maximum values
+    for (int t = 0; t < timeSteps; t++) {
+        fprintf(fp, "(%g, %g)", globalResults->minValues[t], globalResults->maxValues[t]);
+        if (t < timeSteps - 1) {
+            fprintf(fp, ", ");
+        }
+    }
+    fprintf(fp, "\n");
+
+    // Line 3: Timing information
+    fprintf(fp, "%g, %g, %g\n", timing->readTime, timing->mainCodeTime, timing->totalTime);
+
+    long written = ftell(fp);
+    fclose(fp);
+    profileEnd(PROFILE_WRITE, written > 0 ? written : 0);
+}
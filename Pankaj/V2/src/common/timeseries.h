@@ -0,0 +1,288 @@
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include <stdbool.h>
+#include "mpi.h"
+
+// Structure to hold timing information
+typedef struct {
+    double readTime;
+    double mainCodeTime;
+    double totalTime;
+} TimingInfo;
+
+// Structure to hold global analysis results
+typedef struct {
+    int* minimaCount;
+    int* maximaCount;
+    double* minValues;
+    double* maxValues;
+} TimeSeriesResults;
+
+// Structure to hold domain decomposition information
+typedef struct {
+    int startX, startY, startZ;
+    int endX, endY, endZ;
+    int width, height, depth;
+    int tempStartX, tempStartY, tempStartZ;
+    int tempEndX, tempEndY, tempEndZ;
+    int tempWidth, tempHeight, tempDepth;
+} SubDomain;
+
+// In-memory order of the local block handed to the kernel
+typedef enum {
+    LAYOUT_POINT_MAJOR,   // [z][y][x][t], as stored in the file
+    LAYOUT_TIME_MAJOR     // [t][z][y][x], transposed after the read
+} DataLayout;
+
+// Extrema kernel used for the compute phase
+typedef enum {
+    KERNEL_SCALAR,        // per-point neighbour tests, one pass per timestep
+    KERNEL_FUSED,         // point-major, all timesteps of a point in one visit
+    KERNEL_SIMD,          // AVX2/AVX-512 row kernel on the time-major layout
+    KERNEL_EARLY          // scalar sweep that stops testing a point once it can be neither
+} KernelVariant;
+
+// Where analyzeLocalData runs the extrema sweep (device.h)
+typedef enum {
+    DEVICE_CPU,           // the kernels above on the host cores
+    DEVICE_GPU,           // CUDA or HIP kernel, builds with GPU=cuda|hip
+    DEVICE_OFFLOAD        // OpenMP target offload, OpenMP builds
+} DeviceKind;
+
+// How rank 0 hands out the padded blocks in the read-and-distribute implementations
+typedef enum {
+    DISTRIBUTE_FLAT,      // one message per rank from rank 0
+    DISTRIBUTE_NODE       // one message per node leader, shared window within the node
+} DistributeMode;
+
+// Which rank holds which block of the process grid (placement.h)
+typedef enum {
+    PLACEMENT_RANK,       // grid position = rank, x fastest
+    PLACEMENT_SOCKET      // the ranks of a socket take consecutive grid positions
+} PlacementMode;
+
+// How the padded blocks get from the file into memory (io.c)
+typedef enum {
+    IO_AUTO,                  // chosen at run time from the problem, the ranks and calibration data
+    IO_INDEPENDENT_ROWS,      // Level 0: one MPI_File_read per x-row
+    IO_COLLECTIVE_ROWS,       // Level 1: one MPI_File_read_all per x-row
+    IO_INDEPENDENT_SUBARRAY,  // Level 2: subarray file view, one MPI_File_read
+    IO_COLLECTIVE_SUBARRAY,   // Level 3: subarray file view, one MPI_File_read_all
+    IO_ROOT_ISEND,            // rank 0 reads the file and MPI_Isends every block
+    IO_ROOT_BSEND             // rank 0 reads the file and MPI_Bsends every block
+} IoStrategy;
+
+// Half-open box [x0, x1) x [y0, y1) x [z0, z1) in padded local coordinates
+typedef struct {
+    int x0, x1;
+    int y0, y1;
+    int z0, z1;
+} LocalBox;
+
+// Most thresholds one run can count against (--threshold)
+#define STATS_MAX_THRESHOLDS 8
+
+// Command line arguments shared by every implementation
+typedef struct {
+    char inputFile[256];
+    char outputFile[256];
+    int pX, pY, pZ;
+    int nX, nY, nZ;
+    int timeSteps;
+
+    // Optional flags after the positional arguments
+    DataLayout layout;    // --layout=point|time
+    KernelVariant kernel; // --kernel=scalar|fused|simd|early
+    int threads;          // --threads=N, OpenMP builds only (0 = OpenMP default)
+    bool overlap;         // --overlap=0|1, halo modes: compute while faces are in flight
+    int window;           // --window=N, streaming mode: timesteps held per buffer (0 = auto)
+    int pipeline;         // --pipeline=N, derived-datatype readers: z-slabs to pipeline (0 = off)
+    DistributeMode distribute; // --distribute=flat|node
+    IoStrategy ioStrategy;     // --io-strategy=auto|level0|level1|level2|level3|isend|bsend
+    char ioCalibration[256];   // --io-calibration=FILE, benchmark_results.csv of earlier runs ("" = none)
+    char ioHints[256];         // --io-hints=FILE, MPI-IO hints for the collective readers ("" = none)
+    bool reduceOverlap;        // --reduce=blocking|overlap, service mode: leave a job's reduction in flight
+    long memoryLimit;          // --memory-limit=BYTES[K|M|G], out-of-core mode: slab buffer per rank (0 = 256 MiB)
+    DeviceKind device;         // --device=cpu|gpu|offload, accelerator for analyzeLocalData
+    int topK;                  // --top-k=K, extended statistics: K strongest minima and maxima per timestep (0 = off)
+    int thresholdCount;        // --threshold=V[,V...], voxels above each value per timestep
+    double thresholds[STATS_MAX_THRESHOLDS];
+    int histogramBins;         // --histogram=BINS:LO:HI, per-timestep value histogram (0 = off)
+    double histogramLow, histogramHigh;
+    PlacementMode placement;   // --placement=rank|socket, grid order over the ranks
+    bool bindReport;           // --bind-report=0|1, print every rank's binding on rank 0
+
+    // Not a flag: global timestep of the block's first series entry, for callers that
+    // analyse the run in timestep windows (extended statistics are kept per global timestep)
+    int stepOffset;
+} ProgramArgs;
+
+// Convert 3D coordinates to 1D array index
+static inline int getLinearIndex(int x, int y, int z, int width, int height, int depth) {
+    (void)depth;
+    return ((z * height + y) * width + x);
+}
+
+// Owned (non-ghost) part of the padded block
+static inline LocalBox ownedBox(const SubDomain* subdomain) {
+    LocalBox box;
+    box.x0 = subdomain->startX - subdomain->tempStartX;
+    box.y0 = subdomain->startY - subdomain->tempStartY;
+    box.z0 = subdomain->startZ - subdomain->tempStartZ;
+    box.x1 = box.x0 + subdomain->width;
+    box.y1 = box.y0 + subdomain->height;
+    box.z1 = box.z0 + subdomain->depth;
+    return box;
+}
+
+static inline bool isEmptyBox(const LocalBox* box) {
+    return box->x0 >= box->x1 || box->y0 >= box->y1 || box->z0 >= box->z1;
+}
+
+static inline LocalBox intersectBox(LocalBox a, LocalBox b) {
+    if (a.x0 < b.x0) a.x0 = b.x0;
+    if (a.y0 < b.y0) a.y0 = b.y0;
+    if (a.z0 < b.z0) a.z0 = b.z0;
+    if (a.x1 > b.x1) a.x1 = b.x1;
+    if (a.y1 > b.y1) a.y1 = b.y1;
+    if (a.z1 > b.z1) a.z1 = b.z1;
+    return a;
+}
+
+// Owned points whose six neighbours all lie inside the padded block
+LocalBox interiorBox(const SubDomain* subdomain);
+
+// Split outer minus inner (inner clipped to outer) into at most 6 disjoint boxes; returns the count
+int splitShell(const LocalBox* outer, const LocalBox* inner, LocalBox shell[6]);
+
+// Split box into at most count disjoint tiles covering it; returns the number of tiles.
+// With tiles == NULL only the number is returned, so callers can size the array.
+int splitTiles(const LocalBox* box, int count, LocalBox* tiles);
+
+// Results of timesteps [t0, ...) seen as a standalone TimeSeriesResults (shares storage)
+static inline TimeSeriesResults resultsWindow(const TimeSeriesResults* results, int t0) {
+    TimeSeriesResults window;
+    window.minimaCount = results->minimaCount + t0;
+    window.maximaCount = results->maximaCount + t0;
+    window.minValues = results->minValues + t0;
+    window.maxValues = results->maxValues + t0;
+    return window;
+}
+
+// Allocate memory for results structure
+TimeSeriesResults* allocateResults(int timeSteps);
+
+// Free memory for results structure
+void freeResults(TimeSeriesResults* results);
+
+// Parse the nine positional arguments (plus optional --flags) and check them against
+// the communicator size. Prints the problem on rank 0 and returns false if the run cannot proceed.
+// Chunked input files (chunked.h) are refused: the raw readers cannot interpret them.
+bool parseArguments(int argc, char** argv, int rank, int size, ProgramArgs* args);
+
+// parseArguments for chunkedIO: accepts chunked files, and dimensions 0 0 0 0 take nX, nY,
+// nZ and timeSteps from the file's header
+bool parseChunkedArguments(int argc, char** argv, int rank, int size, ProgramArgs* args);
+
+// Calculate subdomain boundaries including ghost zones; rank's block is the one at its
+// grid position (placement.h), which is rank itself unless --placement=socket
+void calculateSubDomainBoundaries(int rank, int pX, int pY, int pZ, int nX, int nY, int nZ, SubDomain* subdomain);
+
+// Find minima, maxima and extreme values of the owned part of a padded local block.
+// Data is point-major: localData[getLinearIndex(x, y, z, ...) * timeSteps + t].
+void processLocalData(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+void processLocalDataDouble(double* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+
+// Same analysis on a time-major block: localData[t * volume + getLinearIndex(x, y, z, ...)]
+void processLocalDataTimeMajor(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+void processLocalDataTimeMajorDouble(double* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+
+// Point-major, single pass: each interior point and its six neighbour series are
+// loaded once and compared for every timestep; boundary points use processBox
+void processLocalDataFused(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+void processLocalDataFusedDouble(double* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+void processBoxFused(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                     TimeSeriesResults* results, int timeSteps);
+void processBoxFusedDouble(const double* localData, const SubDomain* subdomain, const LocalBox* box,
+                           TimeSeriesResults* results, int timeSteps);
+
+// Accumulate the analysis of one box of the padded block into results
+void processBox(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                TimeSeriesResults* results, int timeSteps);
+void processBoxDouble(const double* localData, const SubDomain* subdomain, const LocalBox* box,
+                      TimeSeriesResults* results, int timeSteps);
+void processBoxTimeMajor(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                         TimeSeriesResults* results, int timeSteps);
+void processBoxTimeMajorDouble(const double* localData, const SubDomain* subdomain, const LocalBox* box,
+                               TimeSeriesResults* results, int timeSteps);
+
+// Same sweeps with early exit: neighbours are tested a pair at a time (x, y, z) and a point
+// is dropped once it can be neither a minimum nor a maximum. Faster on smooth fields,
+// slower on noise, where the exits defeat branch prediction.
+void processBoxEarly(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                     TimeSeriesResults* results, int timeSteps);
+void processBoxEarlyDouble(const double* localData, const SubDomain* subdomain, const LocalBox* box,
+                           TimeSeriesResults* results, int timeSteps);
+void processBoxTimeMajorEarly(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                              TimeSeriesResults* results, int timeSteps);
+void processBoxTimeMajorEarlyDouble(const double* localData, const SubDomain* subdomain, const LocalBox* box,
+                                    TimeSeriesResults* results, int timeSteps);
+void processLocalDataEarly(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+void processLocalDataEarlyDouble(double* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+
+// Vectorized time-major kernel (extrema_simd.c): whole x-rows of the interior are compared
+// against their shifted neighbours, the faces on the global boundary go through processBoxTimeMajor.
+// Uses AVX-512 or AVX2 when the CPU supports them and a scalar row loop otherwise.
+void processBoxSimd(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                    TimeSeriesResults* results, int timeSteps);
+void processLocalDataSimd(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+
+// Copy a point-major padded block into a newly allocated time-major block (NULL on failure)
+float* transposeToTimeMajor(const float* localData, const SubDomain* subdomain, int timeSteps);
+double* transposeToTimeMajorDouble(const double* localData, const SubDomain* subdomain, int timeSteps);
+
+// Entry point used by the implementations: analyse a point-major block with the
+// layout and kernel selected on the command line. OpenMP builds split the owned box
+// into tiles across threads, each with private results merged at the end. With
+// --device=gpu|offload the owned box is swept on the accelerator instead, and with
+// --top-k/--threshold/--histogram by the point-major statistics sweep (stats.h).
+void analyzeLocalData(float* localData, const SubDomain* subdomain, TimeSeriesResults* results, const ProgramArgs* args);
+void analyzeLocalDataDouble(double* localData, const SubDomain* subdomain, TimeSeriesResults* results, const ProgramArgs* args);
+
+// Analyse one box of a point-major block in place (no transpose): scalar or fused kernel,
+// threaded like analyzeLocalData (statistics included). Lets callers sweep parts of the
+// block at different times.
+void analyzeLocalBox(const float* localData, const SubDomain* subdomain, const LocalBox* box,
+                     TimeSeriesResults* results, const ProgramArgs* args);
+void analyzeLocalBoxDouble(const double* localData, const SubDomain* subdomain, const LocalBox* box,
+                           TimeSeriesResults* results, const ProgramArgs* args);
+
+// Fold partial results (another thread, tile or rank) into results
+void mergeResults(TimeSeriesResults* results, const TimeSeriesResults* partial, int timeSteps);
+
+// Combine per-rank results on rank 0 of comm (globalResults is only used on rank 0).
+// The four arrays travel as one buffer of per-timestep records {minima, maxima, min, max}
+// reduced by a single user-defined MPI_Op: one collective instead of four.
+void reduceResults(const TimeSeriesResults* localResults, TimeSeriesResults* globalResults,
+                   int timeSteps, MPI_Comm comm);
+
+// Non-blocking form: start packs localResults (which may be reused at once) and posts an
+// MPI_Ireduce; finish waits and unpacks into globalResults on rank 0
+typedef struct {
+    double* send;
+    double* recv;
+    MPI_Request request;
+    TimeSeriesResults* globalResults;
+    int timeSteps;
+    int rank;
+} ResultsReduction;
+
+void reduceResultsStart(const TimeSeriesResults* localResults, TimeSeriesResults* globalResults,
+                        int timeSteps, MPI_Comm comm, ResultsReduction* reduction);
+void reduceResultsFinish(ResultsReduction* reduction);
+
+// Write results to output file
+void writeResults(const char* outputFile, const TimeSeriesResults* globalResults, int timeSteps, const TimingInfo* timing);
+
+#endif // TIMESERIES_H
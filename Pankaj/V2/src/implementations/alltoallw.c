@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "distribute.h"
+#include "profile.h"
+#include "stats.h"
+#include "placement.h"
+
+// Optimized binary file reading function
+float* readInputData(const char* inputFile, long totalDomainSize, int timeSteps) {
+    const long totalValues = totalDomainSize * timeSteps;
+    float* data = (float*)malloc(totalValues * sizeof(float));
+    if (!data) {
+        printf("Failed to allocate memory for input data\n");
+        return NULL;
+    }
+
+    profileBegin(PROFILE_OPEN);
+    FILE* fp = fopen(inputFile, "rb");  // Open in binary mode
+    profileEnd(PROFILE_OPEN, 0);
+    if (!fp) {
+        printf("Failed to open input file: %s\n", inputFile);
+        free(data);
+        return NULL;
+    }
+
+    // Use buffered I/O for better performance
+    char* buffer = (char*)malloc(8192 * 1024); // 8MB buffer
+    if (buffer) {
+        setvbuf(fp, buffer, _IOFBF, 8192 * 1024);
+    }
+
+    // Read directly into data array in large blocks
+    const int BLOCK_SIZE = 1024 * 1024;  // 1M floats at a time
+    profileBegin(PROFILE_READ);
+    for (long offset = 0; offset < totalValues; offset += BLOCK_SIZE) {
+        int itemsToRead = (offset + BLOCK_SIZE <= totalValues) ?
+                         BLOCK_SIZE : (int)(totalValues - offset);
+
+        size_t itemsRead = fread(data + offset, sizeof(float), itemsToRead, fp);
+
+        if (itemsRead != itemsToRead) {
+            printf("Error reading data: expected %d items, got %zu\n", itemsToRead, itemsRead);
+            profileEnd(PROFILE_READ, 0);
+            free(data);
+            if (buffer) free(buffer);
+            fclose(fp);
+            return NULL;
+        }
+    }
+    profileEnd(PROFILE_READ, (double)totalValues * sizeof(float));
+
+    if (buffer) free(buffer);
+    fclose(fp);
+    return data;
+}
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Parse command line arguments
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Start timing
+    double startTime = MPI_Wtime();
+
+    // Calculate domain decomposition
+    SubDomain subdomain;
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
+
+    // Read and distribute data
+    float* localData = NULL;
+    float* globalData = NULL;
+    long totalDomainSize = (long)args.nX * args.nY * args.nZ;
+
+    if (rank == 0) {
+        globalData = readInputData(args.inputFile, totalDomainSize, args.timeSteps);
+        if (!globalData) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+            return 1;
+        }
+    }
+
+    // One MPI_Alltoallw hands every rank its padded block straight out of globalData;
+    // where the kernel allows it rank 0 keeps no copy and analyses globalData itself
+    bool rootInPlace = rootAnalysesInPlace(&args);
+    SubDomain rootView;
+    const SubDomain* analysisDomain = &subdomain;
+    if (rank == 0 && rootInPlace) {
+        rootView = wholeDomainView(&subdomain, args.nX, args.nY, args.nZ);
+        analysisDomain = &rootView;
+        localData = globalData;
+    } else {
+        long localDataSize = (long)subdomain.tempWidth * subdomain.tempHeight * subdomain.tempDepth * args.timeSteps;
+        localData = (float*)allocateLocalBlock(&subdomain, localDataSize * sizeof(float));
+        if (!localData) {
+            printf("Rank %d: Failed to allocate memory for local data\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+            return 1;
+        }
+    }
+
+    if (!scatterBlocks(globalData, localData, MPI_FLOAT, &subdomain, &args, rootInPlace, MPI_COMM_WORLD)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // Rank 0 no longer needs the global array unless it analyses inside it
+    if (rank == 0 && !rootInPlace) {
+        free(globalData);
+    }
+
+    // Start main code timing
+    double mainStartTime = MPI_Wtime();
+
+    // Allocate structures for results
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
+    TimeSeriesResults* globalResults = NULL;
+
+    // Process local data
+    analyzeLocalData(localData, analysisDomain, localResults, &args);
+
+    // Allocate global results on root process
+    if (rank == 0) {
+        globalResults = allocateResults(args.timeSteps);
+    }
+
+    // Reduce results
+    reduceResults(localResults, globalResults, args.timeSteps, MPI_COMM_WORLD);
+
+    // End main code timing
+    double endTime = MPI_Wtime();
+
+    // Compute timing information
+    TimingInfo timing;
+    timing.readTime = mainStartTime - startTime;
+    timing.mainCodeTime = endTime - mainStartTime;
+    timing.totalTime = endTime - startTime;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Write results to file
+    if (rank == 0) {
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s\n", args.outputFile);
+        freeResults(globalResults);
+    }
+
+    // Clean up (on rank 0 localData may be globalData)
+    freeResults(localResults);
+    free(localData);
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+    return 0;
+}
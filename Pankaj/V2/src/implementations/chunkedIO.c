@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "dataset.h"
+#include "chunked.h"
+#include "profile.h"
+#include "stats.h"
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Parse command line arguments (0 0 0 0 takes the dimensions from the header)
+    ProgramArgs args;
+    if (!parseChunkedArguments(argc, argv, rank, size, &args)) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Every rank needs the brick geometry; the header is small enough to read everywhere
+    ChunkedHeader header;
+    if (!readChunkedHeader(args.inputFile, &header)) {
+        if (rank == 0) {
+            printf("Error: %s is not a chunked file (convert it with raw_to_chunked)\n", args.inputFile);
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+    if (header.nX != args.nX || header.nY != args.nY || header.nZ != args.nZ || header.timeSteps != args.timeSteps) {
+        if (rank == 0) {
+            printf("Error: %s is %d x %d x %d x %d but the command line says %d x %d x %d x %d\n", args.inputFile,
+                   header.nX, header.nY, header.nZ, header.timeSteps, args.nX, args.nY, args.nZ, args.timeSteps);
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // The header carries the element type; no side-car or size check applies
+    MPI_Datatype elementType = header.dtype == 1 ? MPI_DOUBLE : MPI_FLOAT;
+    if (rank == 0) {
+        printf("Element type: %s (chunked header)\n", header.dtype == 1 ? "float64" : "float32");
+        printf("Bricks: %d x %d x %d, stride %lld bytes, codec %s\n", header.brickX, header.brickY, header.brickZ,
+               (long long)header.brickStride, chunkedCodecName(header.codec));
+    }
+
+    // Start timing
+    double time1 = MPI_Wtime();
+
+    // Calculate domain decomposition
+    SubDomain subdomain;
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
+
+    void* localData = readChunkedBlock(args.inputFile, &header, &subdomain, MPI_COMM_WORLD);
+    if (!localData) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // End of read timing
+    double time2 = MPI_Wtime();
+
+    // Allocate structures for results
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
+    TimeSeriesResults* globalResults = NULL;
+
+    // Process local data
+    analyzeLocalDataAs(elementType, localData, &subdomain, localResults, &args);
+
+    // Allocate global results on root process
+    if (rank == 0) {
+        globalResults = allocateResults(args.timeSteps);
+    }
+
+    // Reduce results
+    reduceResults(localResults, globalResults, args.timeSteps, MPI_COMM_WORLD);
+
+    // The global min/max are an index lookup; the sweep still reads every brick because the
+    // extrema counts need every point. Without a readable index the sweep's values stand.
+    if (rank == 0) {
+        TimeSeriesResults* indexed = allocateResults(args.timeSteps);
+        for (int t = 0; t < args.timeSteps; t++) {
+            indexed->minValues[t] = DBL_MAX;
+            indexed->maxValues[t] = -DBL_MAX;
+        }
+        if (chunkedGlobalExtrema(args.inputFile, &header, indexed)) {
+            for (int t = 0; t < args.timeSteps; t++) {
+                globalResults->minValues[t] = indexed->minValues[t];
+                globalResults->maxValues[t] = indexed->maxValues[t];
+            }
+        }
+        freeResults(indexed);
+    }
+
+    // End main code timing
+    double time3 = MPI_Wtime();
+
+    // Compute timing information
+    TimingInfo timing;
+    timing.readTime = time2 - time1;
+    timing.mainCodeTime = time3 - time2;
+    timing.totalTime = time3 - time1;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Write results to file
+    if (rank == 0) {
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s\n", args.outputFile);
+        freeResults(globalResults);
+    }
+
+    // Clean up
+    freeResults(localResults);
+    free(localData);
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "stream.h"
+#include "state.h"
+#include "profile.h"
+#include "stats.h"
+
+// Incremental mode for files that keep growing in time: results of the timesteps
+// analysed by earlier runs come from "<outputFile>.state", and only the new range
+// [stored, timeSteps) is read, as time windows of the point-major file
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Parse command line arguments
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Allocate global results on root process; stored timesteps land there directly
+    TimeSeriesResults* globalResults = NULL;
+    if (rank == 0) {
+        globalResults = allocateResults(args.timeSteps);
+    }
+    const int stored = loadResultsState(&args, globalResults, MPI_COMM_WORLD);
+    const int fresh = args.timeSteps - stored;
+
+    // Start timing
+    double time1 = MPI_Wtime();
+
+    // Calculate domain decomposition
+    SubDomain subdomain;
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
+
+    // Allocate structures for results
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
+
+    double analysisTime = 0.0;
+    if (fresh > 0) {
+        ProgramArgs freshArgs = args;
+        freshArgs.timeSteps = fresh;
+        int window = streamWindowSize(&subdomain, &freshArgs, MPI_COMM_WORLD);
+        if (rank == 0) {
+            printf("Incremental: %d timesteps from the state file, %d new (windows of %d)\n", stored, fresh, window);
+        }
+
+        TimeWindowReader reader;
+        if (!streamOpen(&reader, args.inputFile, &subdomain, &args, window, stored, MPI_COMM_WORLD)) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+            return 1;
+        }
+
+        int start, count;
+        float* windowData;
+        while ((windowData = streamNext(&reader, &start, &count)) != NULL) {
+            double analysisStart = MPI_Wtime();
+
+            ProgramArgs windowArgs = args;
+            windowArgs.timeSteps = count;
+            windowArgs.stepOffset = start;
+            TimeSeriesResults windowResults = resultsWindow(localResults, start);
+            analyzeLocalData(windowData, &subdomain, &windowResults, &windowArgs);
+
+            analysisTime += MPI_Wtime() - analysisStart;
+        }
+        streamClose(&reader);
+    } else if (rank == 0) {
+        printf("Incremental: all %d timesteps from the state file, nothing new to read\n", stored);
+    }
+
+    double readWait = MPI_Wtime() - time1 - analysisTime;
+
+    // Reduce only the new timesteps
+    if (fresh > 0) {
+        TimeSeriesResults localFresh = resultsWindow(localResults, stored);
+        TimeSeriesResults globalFresh = rank == 0 ? resultsWindow(globalResults, stored) : localFresh;
+        reduceResults(&localFresh, rank == 0 ? &globalFresh : NULL, fresh, MPI_COMM_WORLD);
+    }
+
+    // End main code timing
+    double time3 = MPI_Wtime();
+
+    // Compute timing information: reads overlap the analysis, so the read time is
+    // only the part of the run spent waiting for data
+    TimingInfo timing;
+    timing.readTime = readWait;
+    timing.mainCodeTime = time3 - time1 - readWait;
+    timing.totalTime = time3 - time1;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Write results to file; the state gains the new timesteps
+    if (rank == 0) {
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        appendResultsState(&args, globalResults, stored, args.timeSteps);
+        printf("Output written to %s\n", args.outputFile);
+        freeResults(globalResults);
+    }
+
+    // Clean up
+    freeResults(localResults);
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "dataset.h"
+#include "mapped.h"
+#include "profile.h"
+#include "stats.h"
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Parse command line arguments
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    MPI_Datatype elementType;
+    if (!datasetElementType(&args, MPI_COMM_WORLD, &elementType)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+    int elementSize;
+    MPI_Type_size(elementType, &elementSize);
+
+    // Start timing
+    double time1 = MPI_Wtime();
+
+    // Calculate domain decomposition
+    SubDomain subdomain;
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
+
+    // No read copy: pages are faulted in by the kernel below, so most of the I/O
+    // shows up in the main code time rather than the read time
+    MappedBlock block;
+    if (!mapBlock(&block, &subdomain, elementSize, &args, MPI_COMM_WORLD)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // End of read timing
+    double time2 = MPI_Wtime();
+
+    // Allocate structures for results
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
+    TimeSeriesResults* globalResults = NULL;
+
+    // Process local data
+    analyzeLocalDataAs(elementType, block.data, &block.view, localResults, &args);
+
+    // Allocate global results on root process
+    if (rank == 0) {
+        globalResults = allocateResults(args.timeSteps);
+    }
+
+    // Reduce results
+    reduceResults(localResults, globalResults, args.timeSteps, MPI_COMM_WORLD);
+
+    // End main code timing
+    double time3 = MPI_Wtime();
+
+    // Compute timing information
+    TimingInfo timing;
+    timing.readTime = time2 - time1;
+    timing.mainCodeTime = time3 - time2;
+    timing.totalTime = time3 - time1;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Write results to file
+    if (rank == 0) {
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s\n", args.outputFile);
+        freeResults(globalResults);
+    }
+
+    // Clean up
+    freeResults(localResults);
+    unmapBlock(&block);
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "dataset.h"
+#include "outofcore.h"
+#include "hints.h"
+#include "profile.h"
+#include "stats.h"
+
+// Out-of-core mode: the padded block is walked in z-slabs that fit --memory-limit, so
+// neither a rank nor rank 0 ever needs its whole block (let alone the volume) in memory
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Parse command line arguments
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    MPI_Datatype elementType;
+    if (!datasetElementType(&args, MPI_COMM_WORLD, &elementType)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // MPI-IO hints from --io-hints, TS_MPIIO_HINTS and the node count
+    MPI_Info info = createIoHints(&args, MPI_COMM_WORLD);
+    reportIoHints(info, MPI_COMM_WORLD);
+
+    // Start timing
+    double time1 = MPI_Wtime();
+
+    // Calculate domain decomposition
+    SubDomain subdomain;
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
+
+    // Allocate structures for results
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
+    TimeSeriesResults* globalResults = NULL;
+
+    // Reads and analysis alternate slab by slab
+    OutOfCoreStats stats;
+    if (!outOfCoreAnalyze(&subdomain, &args, elementType, info, MPI_COMM_WORLD, localResults, &stats)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // Allocate global results on root process
+    if (rank == 0) {
+        globalResults = allocateResults(args.timeSteps);
+    }
+
+    // Reduce results
+    reduceResults(localResults, globalResults, args.timeSteps, MPI_COMM_WORLD);
+    reportOutOfCoreStats(&stats, MPI_COMM_WORLD);
+
+    // End main code timing
+    double time3 = MPI_Wtime();
+
+    // Compute timing information: the read time is the sum of the slab reads
+    TimingInfo timing;
+    timing.readTime = stats.readTime;
+    timing.mainCodeTime = time3 - time1 - stats.readTime;
+    timing.totalTime = time3 - time1;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Write results to file
+    if (rank == 0) {
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s\n", args.outputFile);
+        freeResults(globalResults);
+    }
+
+    // Clean up
+    freeResults(localResults);
+    MPI_Info_free(&info);
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+    return 0;
+}
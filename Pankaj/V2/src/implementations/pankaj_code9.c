@@ -1,174 +1,27 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <float.h>
-#include <stdbool.h>
 #include "mpi.h"
-
-// Structure to hold timing information
-typedef struct {
-    double readTime;
-    double mainCodeTime;
-    double totalTime;
-} TimingInfo;
-
-// Structure to hold global analysis results
-typedef struct {
-    int* minimaCount;
-    int* maximaCount;
-    double* minValues;
-    double* maxValues;
-} TimeSeriesResults;
-
-// Structure to hold domain decomposition information
-typedef struct {
-    int startX, startY, startZ;
-    int endX, endY, endZ;
-    int width, height, depth;
-    int tempStartX, tempStartY, tempStartZ;
-    int tempEndX, tempEndY, tempEndZ;
-    int tempWidth, tempHeight, tempDepth;
-} SubDomain;
-
-// Convert 3D coordinates to 1D array index
-int getLinearIndex(int x, int y, int z, int width, int height, int depth) {
-    return ((z * height + y) * width + x);
-}
-
-// Allocate memory for results structure
-TimeSeriesResults* allocateResults(int timeSteps) {
-    TimeSeriesResults* results = (TimeSeriesResults*)malloc(sizeof(TimeSeriesResults));
-    if (!results) return NULL;
-
-    results->minimaCount = (int*)calloc(timeSteps, sizeof(int));
-    results->maximaCount = (int*)calloc(timeSteps, sizeof(int));
-    results->minValues = (double*)malloc(timeSteps * sizeof(double));
-    results->maxValues = (double*)malloc(timeSteps * sizeof(double));
-
-    // Initialize min/max values
-    for (int t = 0; t < timeSteps; t++) {
-        results->minValues[t] = DBL_MAX;
-        results->maxValues[t] = -DBL_MAX;
-    }
-
-    return results;
-}
-
-// Free memory for results structure
-void freeResults(TimeSeriesResults* results) {
-    if (!results) return;
-
-    free(results->minimaCount);
-    free(results->maximaCount);
-    free(results->minValues);
-    free(results->maxValues);
-    free(results);
-}
-
-// Check if a point is a local minimum
-bool isLocalMinimum(double* data, int x, int y, int z, int width, int height, int depth, int time, int timeSteps) {
-    int idx = getLinearIndex(x, y, z, width, height, depth);
-    double value = data[idx * timeSteps + time];
-
-    // Check all six neighbors (if they exist)
-    // X-axis neighbors
-    if (x > 0 && data[getLinearIndex(x-1, y, z, width, height, depth) * timeSteps + time] < value)
-        return false;
-    if (x < width-1 && data[getLinearIndex(x+1, y, z, width, height, depth) * timeSteps + time] < value)
-        return false;
-
-    // Y-axis neighbors
-    if (y > 0 && data[getLinearIndex(x, y-1, z, width, height, depth) * timeSteps + time] < value)
-        return false;
-    if (y < height-1 && data[getLinearIndex(x, y+1, z, width, height, depth) * timeSteps + time] < value)
-        return false;
-
-    // Z-axis neighbors
-    if (z > 0 && data[getLinearIndex(x, y, z-1, width, height, depth) * timeSteps + time] < value)
-        return false;
-    if (z < depth-1 && data[getLinearIndex(x, y, z+1, width, height, depth) * timeSteps + time] < value)
-        return false;
-
-    return true;
-}
-
-// Check if a point is a local maximum
-bool isLocalMaximum(double* data, int x, int y, int z, int width, int height, int depth, int time, int timeSteps) {
-    int idx = getLinearIndex(x, y, z, width, height, depth);
-    double value = data[idx * timeSteps + time];
-
-    // Check all six neighbors (if they exist)
-    // X-axis neighbors
-    if (x > 0 && data[getLinearIndex(x-1, y, z, width, height, depth) * timeSteps + time] > value)
-        return false;
-    if (x < width-1 && data[getLinearIndex(x+1, y, z, width, height, depth) * timeSteps + time] > value)
-        return false;
-
-    // Y-axis neighbors
-    if (y > 0 && data[getLinearIndex(x, y-1, z, width, height, depth) * timeSteps + time] > value)
-        return false;
-    if (y < height-1 && data[getLinearIndex(x, y+1, z, width, height, depth) * timeSteps + time] > value)
-        return false;
-
-    // Z-axis neighbors
-    if (z > 0 && data[getLinearIndex(x, y, z-1, width, height, depth) * timeSteps + time] > value)
-        return false;
-    if (z < depth-1 && data[getLinearIndex(x, y, z+1, width, height, depth) * timeSteps + time] > value)
-        return false;
-
-    return true;
-}
-
-// Calculate subdomain boundaries including ghost zones
-void calculateSubDomainBoundaries(int rank, int pX, int pY, int pZ, int nX, int nY, int nZ, SubDomain* subdomain) {
-    // Calculate process position in the 3D process grid
-    int posZ = rank / (pX * pY);
-    int posY = (rank % (pX * pY)) / pX;
-    int posX = rank % pX;
-
-    // Calculate subdomain size
-    int subSizeX = nX / pX;
-    int subSizeY = nY / pY;
-    int subSizeZ = nZ / pZ;
-
-    // Calculate boundaries of actual subdomain (without ghost zones)
-    subdomain->startX = posX * subSizeX;
-    subdomain->startY = posY * subSizeY;
-    subdomain->startZ = posZ * subSizeZ;
-
-    // Handle edge processes that might get slightly larger domains due to division remainder
-    subdomain->endX = (posX == pX - 1) ? nX - 1 : subdomain->startX + subSizeX - 1;
-    subdomain->endY = (posY == pY - 1) ? nY - 1 : subdomain->startY + subSizeY - 1;
-    subdomain->endZ = (posZ == pZ - 1) ? nZ - 1 : subdomain->startZ + subSizeZ - 1;
-
-    // Calculate boundaries including ghost zones
-    subdomain->tempStartX = (subdomain->startX > 0) ? subdomain->startX - 1 : subdomain->startX;
-    subdomain->tempStartY = (subdomain->startY > 0) ? subdomain->startY - 1 : subdomain->startY;
-    subdomain->tempStartZ = (subdomain->startZ > 0) ? subdomain->startZ - 1 : subdomain->startZ;
-
-    subdomain->tempEndX = (subdomain->endX < nX - 1) ? subdomain->endX + 1 : subdomain->endX;
-    subdomain->tempEndY = (subdomain->endY < nY - 1) ? subdomain->endY + 1 : subdomain->endY;
-    subdomain->tempEndZ = (subdomain->endZ < nZ - 1) ? subdomain->endZ + 1 : subdomain->endZ;
-
-    // Calculate dimensions
-    subdomain->width = subdomain->endX - subdomain->startX + 1;
-    subdomain->height = subdomain->endY - subdomain->startY + 1;
-    subdomain->depth = subdomain->endZ - subdomain->startZ + 1;
-
-    subdomain->tempWidth = subdomain->tempEndX - subdomain->tempStartX + 1;
-    subdomain->tempHeight = subdomain->tempEndY - subdomain->tempStartY + 1;
-    subdomain->tempDepth = subdomain->tempEndZ - subdomain->tempStartZ + 1;
-}
-
-// Optimized binary file reading function
-double* readInputData(const char* inputFile, int totalDomainSize, int timeSteps) {
-    double* data = (double*)malloc(totalDomainSize * timeSteps * sizeof(double));
+#include "timeseries.h"
+#include "distribute.h"
+#include "dataset.h"
+#include "nodeshare.h"
+#include "profile.h"
+#include "stats.h"
+#include "placement.h"
+
+// Read the whole file on rank 0 in its native element type (elementSize bytes per value)
+void* readInputData(const char* inputFile, long totalDomainSize, int timeSteps, int elementSize) {
+    const size_t totalValues = (size_t)totalDomainSize * timeSteps;
+    char* data = (char*)malloc(totalValues * elementSize);
     if (!data) {
         printf("Failed to allocate memory for input data\n");
         return NULL;
     }
 
+    profileBegin(PROFILE_OPEN);
     FILE* fp = fopen(inputFile, "rb");  // Open in binary mode
+    profileEnd(PROFILE_OPEN, 0);
     if (!fp) {
         printf("Failed to open input file: %s\n", inputFile);
         free(data);
@@ -181,57 +34,40 @@ double* readInputData(const char* inputFile, int totalDomainSize, int timeSteps)
         setvbuf(fp, buffer, _IOFBF, 8192 * 1024);
     }
 
-    // Allocate a temporary buffer for reading floats
-    const int BLOCK_SIZE = 1024;
-    float* floatBuffer = (float*)malloc(BLOCK_SIZE * timeSteps * sizeof(float));
-    if (!floatBuffer) {
-        printf("Failed to allocate memory for float buffer\n");
-        free(data);
-        if (buffer) free(buffer);
-        fclose(fp);
-        return NULL;
-    }
+    // Read straight into the global array in large blocks, no conversion
+    const size_t BLOCK_SIZE = 1024 * 1024;  // 1M values at a time
+    profileBegin(PROFILE_READ);
+    for (size_t offset = 0; offset < totalValues; offset += BLOCK_SIZE) {
+        size_t itemsToRead = (offset + BLOCK_SIZE <= totalValues) ? BLOCK_SIZE : totalValues - offset;
 
-    // Read data in blocks and convert from float to double
-    for (int point = 0; point < totalDomainSize; point += BLOCK_SIZE) {
-        int blockEnd = (point + BLOCK_SIZE < totalDomainSize) ?
-                      point + BLOCK_SIZE : totalDomainSize;
-        int pointsToRead = blockEnd - point;
+        size_t itemsRead = fread(data + offset * elementSize, elementSize, itemsToRead, fp);
 
-        // Read a block of float values
-        size_t itemsRead = fread(floatBuffer, sizeof(float), pointsToRead * timeSteps, fp);
-
-        if (itemsRead != pointsToRead * timeSteps) {
-            printf("Error reading data: expected %d items, got %zu\n",
-                   pointsToRead * timeSteps, itemsRead);
+        if (itemsRead != itemsToRead) {
+            printf("Error reading data: expected %zu items, got %zu\n", itemsToRead, itemsRead);
+            profileEnd(PROFILE_READ, 0);
             free(data);
-            free(floatBuffer);
             if (buffer) free(buffer);
             fclose(fp);
             return NULL;
         }
-
-        // Convert float values to double
-        for (int p = 0; p < pointsToRead; p++) {
-            for (int t = 0; t < timeSteps; t++) {
-                data[(point + p) * timeSteps + t] = (double)floatBuffer[p * timeSteps + t];
-            }
-        }
     }
+    profileEnd(PROFILE_READ, (double)totalValues * elementSize);
 
-    free(floatBuffer);
     if (buffer) free(buffer);
     fclose(fp);
     return data;
 }
 
 // Optimized data distribution with improved memory access patterns using `memcpy` to copy entire rows at once
-double* distributeData(int rank, const SubDomain* subdomain, double* globalData,
+void* distributeData(int rank, const SubDomain* subdomain, const void* globalData, MPI_Datatype elementType,
                       int nX, int nY, int nZ, int timeSteps, int pX, int pY, int pZ) {
     int localDataSize = subdomain->tempWidth * subdomain->tempHeight *
                         subdomain->tempDepth * timeSteps;
 
-    double* localData = (double*)malloc(localDataSize * sizeof(double));
+    int elementSize;
+    MPI_Type_size(elementType, &elementSize);
+
+    char* localData = (char*)allocateLocalBlock(subdomain, (size_t)localDataSize * elementSize);
     if (!localData) {
         printf("Rank %d: Failed to allocate memory for local data\n", rank);
         return NULL;
@@ -239,139 +75,49 @@ double* distributeData(int rank, const SubDomain* subdomain, double* globalData,
 
     if (rank == 0) {
         // Root process copies its own data using memcpy for entire rows
-        int idx = 0;
+        const char* globalBytes = (const char*)globalData;
+        size_t idx = 0;
+        profileBegin(PROFILE_PACK);
         for (int z = subdomain->tempStartZ; z <= subdomain->tempEndZ; z++) {
             for (int y = subdomain->tempStartY; y <= subdomain->tempEndY; y++) {
                 // Calculate start of row in global data
-                int globalRowStart = getLinearIndex(subdomain->tempStartX, y, z, nX, nY, nZ) * timeSteps;
+                size_t globalRowStart = (size_t)getLinearIndex(subdomain->tempStartX, y, z, nX, nY, nZ) * timeSteps * elementSize;
 
                 // Copy entire row at once (all X values for this Y,Z coordinate)
-                int rowSize = subdomain->tempWidth * timeSteps * sizeof(double);
-                memcpy(&localData[idx], &globalData[globalRowStart], rowSize);
+                size_t rowSize = (size_t)subdomain->tempWidth * timeSteps * elementSize;
+                memcpy(&localData[idx], &globalBytes[globalRowStart], rowSize);
 
                 // Update index for next row
-                idx += subdomain->tempWidth * timeSteps;
+                idx += rowSize;
             }
         }
+        profileEnd(PROFILE_PACK, (double)localDataSize * elementSize);
 
         // Send data to other processes
+        double sentBytes = 0;
+        profileBegin(PROFILE_SEND);
         for (int p = 1; p < pX * pY * pZ; p++) {
             SubDomain recvSubdomain;
             calculateSubDomainBoundaries(p, pX, pY, pZ, nX, nY, nZ, &recvSubdomain);
 
-            int sendDataSize = recvSubdomain.tempWidth * recvSubdomain.tempHeight *
-                              recvSubdomain.tempDepth * timeSteps;
-
-            double* tempBuffer = (double*)malloc(sendDataSize * sizeof(double));
-            if (!tempBuffer) {
-                printf("Rank 0: Failed to allocate temp buffer for process %d\n", p);
-                free(localData);
-                return NULL;
-            }
-
-            int bufIdx = 0;
-            for (int z = recvSubdomain.tempStartZ; z <= recvSubdomain.tempEndZ; z++) {
-                for (int y = recvSubdomain.tempStartY; y <= recvSubdomain.tempEndY; y++) {
-                    // Calculate start of row in global data
-                    int globalRowStart = getLinearIndex(recvSubdomain.tempStartX, y, z, nX, nY, nZ) * timeSteps;
-
-                    // Copy entire row at once for better cache performance
-                    int rowSize = recvSubdomain.tempWidth * timeSteps * sizeof(double);
-                    memcpy(&tempBuffer[bufIdx], &globalData[globalRowStart], rowSize);
-
-                    // Update buffer index
-                    bufIdx += recvSubdomain.tempWidth * timeSteps;
-                }
-            }
-
-            MPI_Send(tempBuffer, sendDataSize, MPI_DOUBLE, p, 0, MPI_COMM_WORLD);
-            free(tempBuffer);
+            // Sent straight out of globalData: no pack buffer
+            MPI_Datatype blockType = createBlockType(&recvSubdomain, nX, nY, nZ, timeSteps, elementType);
+            MPI_Send(globalData, 1, blockType, p, 0, MPI_COMM_WORLD);
+            MPI_Type_free(&blockType);
+            sentBytes += (double)recvSubdomain.tempWidth * recvSubdomain.tempHeight *
+                         recvSubdomain.tempDepth * timeSteps * elementSize;
         }
+        profileEnd(PROFILE_SEND, sentBytes);
     } else {
         // Receive data from root
-        MPI_Recv(localData, localDataSize, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        profileBegin(PROFILE_WAIT);
+        MPI_Recv(localData, localDataSize, elementType, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        profileEnd(PROFILE_WAIT, (double)localDataSize * elementSize);
     }
 
     return localData;
 }
 
-// Process local data to find minima, maxima, and extreme values
-void processLocalData(double* localData, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
-    for (int t = 0; t < timeSteps; t++) {
-        int minimaCount = 0;
-        int maximaCount = 0;
-
-        for (int z = 0; z < subdomain->tempDepth; z++) {
-            for (int y = 0; y < subdomain->tempHeight; y++) {
-                for (int x = 0; x < subdomain->tempWidth; x++) {
-                    // Check if this point is within the actual subdomain (not ghost zone)
-                    bool isActualPoint = (x >= (subdomain->startX - subdomain->tempStartX) &&
-                                         x <= (subdomain->endX - subdomain->tempStartX) &&
-                                         y >= (subdomain->startY - subdomain->tempStartY) &&
-                                         y <= (subdomain->endY - subdomain->tempStartY) &&
-                                         z >= (subdomain->startZ - subdomain->tempStartZ) &&
-                                         z <= (subdomain->endZ - subdomain->tempStartZ));
-
-                    if (isActualPoint) {
-                        int idx = getLinearIndex(x, y, z, subdomain->tempWidth, subdomain->tempHeight, subdomain->tempDepth);
-                        double value = localData[idx * timeSteps + t];
-
-                        // Update min/max values
-                        if (value < results->minValues[t]) results->minValues[t] = value;
-                        if (value > results->maxValues[t]) results->maxValues[t] = value;
-
-                        // Check for local minima/maxima
-                        if (isLocalMinimum(localData, x, y, z, subdomain->tempWidth, subdomain->tempHeight,
-                                         subdomain->tempDepth, t, timeSteps)) {
-                            minimaCount++;
-                        }
-
-                        if (isLocalMaximum(localData, x, y, z, subdomain->tempWidth, subdomain->tempHeight,
-                                          subdomain->tempDepth, t, timeSteps)) {
-                            maximaCount++;
-                        }
-                    }
-                }
-            }
-        }
-
-        results->minimaCount[t] = minimaCount;
-        results->maximaCount[t] = maximaCount;
-    }
-}
-
-// Write results to output file
-void writeResults(const char* outputFile, const TimeSeriesResults* globalResults, int timeSteps, const TimingInfo* timing) {
-    FILE* fp = fopen(outputFile, "w");
-    if (!fp) {
-        printf("Error: Cannot open output file %s\n", outputFile);
-        return;
-    }
-
-    // Line 1: Local minima and maxima counts
-    for (int t = 0; t < timeSteps; t++) {
-        fprintf(fp, "(%d, %d)", globalResults->minimaCount[t], globalResults->maximaCount[t]);
-        if (t < timeSteps - 1) {
-            fprintf(fp, ", ");
-        }
-    }
-    fprintf(fp, "\n");
-
-    // Line 2: Global minimum and maximum values
-    for (int t = 0; t < timeSteps; t++) {
-        fprintf(fp, "(%g, %g)", globalResults->minValues[t], globalResults->maxValues[t]);
-        if (t < timeSteps - 1) {
-            fprintf(fp, ", ");
-        }
-    }
-    fprintf(fp, "\n");
-
-    // Line 3: Timing information
-    fprintf(fp, "%g, %g, %g\n", timing->readTime, timing->mainCodeTime, timing->totalTime);
-
-    fclose(fp);
-}
-
 int main(int argc, char** argv) {
     int rank, size;
 
@@ -379,62 +125,60 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    // Check for correct number of arguments
-    if (argc != 10) {
-        if (rank == 0) {
-            printf("Usage: %s <inputFile> <pX> <pY> <pZ> <nX> <nY> <nZ> <timeSteps> <outputFile>\n", argv[0]);
-        }
+    // Parse command line arguments
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) {
         MPI_Finalize();
         return 1;
     }
 
-    // Parse command line arguments
-    char inputFile[256], outputFile[256];
-    strcpy(inputFile, argv[1]);
-    int pX = atoi(argv[2]);
-    int pY = atoi(argv[3]);
-    int pZ = atoi(argv[4]);
-    int nX = atoi(argv[5]);
-    int nY = atoi(argv[6]);
-    int nZ = atoi(argv[7]);
-    int timeSteps = atoi(argv[8]);
-    strcpy(outputFile, argv[9]);
-
-    // Verify process grid matches total number of processes
-    if (pX * pY * pZ != size) {
-        if (rank == 0) {
-            printf("Error: pX*pY*pZ (%d) must equal the total number of processes (%d)\n", pX*pY*pZ, size);
-        }
+    // Values are read, sent and compared in the file's own precision
+    MPI_Datatype elementType;
+    if (!datasetElementType(&args, MPI_COMM_WORLD, &elementType)) {
         MPI_Finalize();
         return 1;
     }
+    int elementSize;
+    MPI_Type_size(elementType, &elementSize);
 
     // Start timing
     double time1 = MPI_Wtime();
 
     // Calculate domain decomposition
     SubDomain subdomain;
-    calculateSubDomainBoundaries(rank, pX, pY, pZ, nX, nY, nZ, &subdomain);
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
 
     // Read and distribute data
-    double* localData = NULL;
-    double* globalData = NULL;
-    int totalDomainSize = nX * nY * nZ;
+    void* localData = NULL;
+    void* globalData = NULL;
+    long totalDomainSize = (long)args.nX * args.nY * args.nZ;
 
     if (rank == 0) {
-        globalData = readInputData(inputFile, totalDomainSize, timeSteps);
+        globalData = readInputData(args.inputFile, totalDomainSize, args.timeSteps, elementSize);
         if (!globalData) {
             MPI_Abort(MPI_COMM_WORLD, 1);
             return 1;
         }
     }
 
-    // Distribute data
-    localData = distributeData(rank, &subdomain, globalData, nX, nY, nZ, timeSteps, pX, pY, pZ);
-    if (!localData) {
-        if (rank == 0 && globalData) free(globalData);
-        MPI_Abort(MPI_COMM_WORLD, 1);
-        return 1;
+    // Distribute data: flat from rank 0, or per node into a shared window
+    NodeSharedBlock nodeBlock;
+    const SubDomain* analysisDomain = &subdomain;
+    if (args.distribute == DISTRIBUTE_NODE) {
+        if (!nodeDistribute(&nodeBlock, globalData, elementType, &subdomain, &args, MPI_COMM_WORLD)) {
+            if (rank == 0 && globalData) free(globalData);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+            return 1;
+        }
+        localData = nodeBlock.data;
+        analysisDomain = &nodeBlock.view;
+    } else {
+        localData = distributeData(rank, &subdomain, globalData, elementType, args.nX, args.nY, args.nZ, args.timeSteps, args.pX, args.pY, args.pZ);
+        if (!localData) {
+            if (rank == 0 && globalData) free(globalData);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+            return 1;
+        }
     }
 
     // Free global data on rank 0 as it's no longer needed
@@ -446,29 +190,19 @@ int main(int argc, char** argv) {
     double time2 = MPI_Wtime();
 
     // Allocate structures for results
-    TimeSeriesResults* localResults = allocateResults(timeSteps);
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
     TimeSeriesResults* globalResults = NULL;
 
     // Process local data
-    processLocalData(localData, &subdomain, localResults, timeSteps);
+    analyzeLocalDataAs(elementType, localData, analysisDomain, localResults, &args);
 
     // Allocate global results on root process
     if (rank == 0) {
-        globalResults = allocateResults(timeSteps);
+        globalResults = allocateResults(args.timeSteps);
     }
 
     // Reduce results
-    MPI_Reduce(localResults->minimaCount, rank == 0 ? globalResults->minimaCount : NULL,
-              timeSteps, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-
-    MPI_Reduce(localResults->maximaCount, rank == 0 ? globalResults->maximaCount : NULL,
-              timeSteps, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-
-    MPI_Reduce(localResults->minValues, rank == 0 ? globalResults->minValues : NULL,
-              timeSteps, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
-
-    MPI_Reduce(localResults->maxValues, rank == 0 ? globalResults->maxValues : NULL,
-              timeSteps, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    reduceResults(localResults, globalResults, args.timeSteps, MPI_COMM_WORLD);
 
     // End main code timing
     double time3 = MPI_Wtime();
@@ -484,14 +218,22 @@ int main(int argc, char** argv) {
 
     // Write results to file
     if (rank == 0) {
-        writeResults(outputFile, globalResults, timeSteps, &maxTiming);
-        printf("Output written to %s\n", outputFile);
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s\n", args.outputFile);
         freeResults(globalResults);
     }
 
     // Clean up
     freeResults(localResults);
-    free(localData);
+    if (args.distribute == DISTRIBUTE_NODE) {
+        nodeSharedFree(&nodeBlock);
+    } else {
+        free(localData);
+    }
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
 
     MPI_Finalize();
     return 0;
@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "dataset.h"
+#include "distribute.h"
+#include "hints.h"
+#include "stats.h"
+
+// Persistent mode: one MPI launch analyses a queue of jobs. Each job line holds the
+// usual positional arguments and options
+//   <inputFile> <pX> <pY> <pZ> <nX> <nY> <nZ> <timeSteps> <outputFile> [options]
+// read from a manifest or stdin ("-"); blank lines and '#' comments are skipped and
+// "quit" ends the queue. Options given to the service itself apply to every job.
+// File types, hints and buffers survive between jobs, so a queue of small volumes
+// pays MPI start-up, type creation and allocation once. With --reduce=overlap a job's
+// reduction completes while the next job reads, and its output is written after that.
+
+#define JOB_LINE 1024
+#define JOB_ARGS 64
+#define TYPE_CACHE 16
+
+// Block file type of this rank for one geometry
+typedef struct {
+    int key[9];               // nX, nY, nZ, timeSteps, pX, pY, pZ, element size, placement
+    SubDomain subdomain;
+    MPI_Datatype fileType;
+} CachedType;
+
+// A job whose reduction is still in flight (--reduce=overlap); its output is written
+// once the next job has read its data, or at the end of the queue
+typedef struct {
+    bool active;
+    ResultsReduction reduction;
+    MPI_Request timingRequest;
+    TimingInfo timing, maxTiming;
+    TimeSeriesResults* globalResults;
+    char outputFile[256];
+    int timeSteps;
+} PendingJob;
+
+typedef struct {
+    CachedType types[TYPE_CACHE];
+    int count, next;
+    int hits, misses;
+
+    MPI_Info info;            // collective read hints, rebuilt when --io-hints changes
+    char infoSource[256];
+    bool haveInfo;
+
+    void* buffer;             // padded block, grown to the largest job
+    size_t bufferBytes;
+    TimeSeriesResults* localResults;
+    TimeSeriesResults* globalResults;
+    int resultsCapacity;
+
+    PendingJob pending;
+} ServiceCache;
+
+static const CachedType* lookupType(ServiceCache* cache, const ProgramArgs* args, int rank, int elementSize,
+                                    MPI_Datatype elementType) {
+    const int key[9] = {args->nX, args->nY, args->nZ, args->timeSteps, args->pX, args->pY, args->pZ, elementSize,
+                        (int)args->placement};
+    for (int i = 0; i < cache->count; i++) {
+        if (memcmp(cache->types[i].key, key, sizeof(key)) == 0) {
+            cache->hits++;
+            return &cache->types[i];
+        }
+    }
+
+    // Round-robin eviction once the cache is full
+    CachedType* entry = &cache->types[cache->next];
+    if (cache->count == TYPE_CACHE) {
+        MPI_Type_free(&entry->fileType);
+    } else {
+        cache->count++;
+    }
+    cache->next = (cache->next + 1) % TYPE_CACHE;
+    cache->misses++;
+
+    memcpy(entry->key, key, sizeof(key));
+    calculateSubDomainBoundaries(rank, args->pX, args->pY, args->pZ, args->nX, args->nY, args->nZ, &entry->subdomain);
+    entry->fileType = createBlockType(&entry->subdomain, args->nX, args->nY, args->nZ, args->timeSteps, elementType);
+    return entry;
+}
+
+static MPI_Info cachedHints(ServiceCache* cache, const ProgramArgs* args, MPI_Comm comm) {
+    if (!cache->haveInfo || strcmp(cache->infoSource, args->ioHints) != 0) {
+        if (cache->haveInfo) MPI_Info_free(&cache->info);
+        cache->info = createIoHints(args, comm);
+        snprintf(cache->infoSource, sizeof(cache->infoSource), "%s", args->ioHints);
+        cache->haveInfo = true;
+    }
+    return cache->info;
+}
+
+// Reuse the buffers when they are large enough; false if they cannot be grown
+static bool reserveBuffers(ServiceCache* cache, size_t bytes, int timeSteps, int rank) {
+    if (bytes > cache->bufferBytes) {
+        void* grown = realloc(cache->buffer, bytes);
+        if (!grown) {
+            printf("Rank %d: Failed to allocate memory for local data\n", rank);
+            return false;
+        }
+        cache->buffer = grown;
+        cache->bufferBytes = bytes;
+    }
+
+    if (timeSteps > cache->resultsCapacity) {
+        freeResults(cache->localResults);
+        freeResults(cache->globalResults);
+        cache->localResults = allocateResults(timeSteps);
+        cache->globalResults = rank == 0 ? allocateResults(timeSteps) : NULL;
+        cache->resultsCapacity = timeSteps;
+    }
+    for (int t = 0; t < timeSteps; t++) {
+        cache->localResults->minimaCount[t] = 0;
+        cache->localResults->maximaCount[t] = 0;
+        cache->localResults->minValues[t] = DBL_MAX;
+        cache->localResults->maxValues[t] = -DBL_MAX;
+    }
+    return true;
+}
+
+static void finishPending(ServiceCache* cache, MPI_Comm comm) {
+    PendingJob* pending = &cache->pending;
+    if (!pending->active) return;
+
+    reduceResultsFinish(&pending->reduction);
+    MPI_Wait(&pending->timingRequest, MPI_STATUS_IGNORE);
+
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == 0) {
+        writeResults(pending->outputFile, pending->globalResults, pending->timeSteps, &pending->maxTiming);
+        printf("Output written to %s (read %g s, total %g s)\n", pending->outputFile,
+               pending->maxTiming.readTime, pending->maxTiming.totalTime);
+        freeResults(pending->globalResults);
+    }
+    pending->active = false;
+}
+
+// One job; collective over comm, and every rank returns the same answer
+static bool runJob(char* line, char* program, int serviceOptionCount, char** serviceOptions,
+                   ServiceCache* cache, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Positional arguments from the job line, then the service-wide options, then the job's
+    char* argv[JOB_ARGS];
+    int argc = 0;
+    argv[argc++] = program;
+    char* options[JOB_ARGS];
+    int optionCount = 0, positional = 0;
+    for (char* token = strtok(line, " \t\r\n"); token; token = strtok(NULL, " \t\r\n")) {
+        if (strncmp(token, "--", 2) == 0) {
+            if (optionCount < JOB_ARGS / 2) options[optionCount++] = token;
+        } else if (++positional <= 9) {
+            argv[argc++] = token;
+        }
+    }
+    if (positional != 9) {
+        if (rank == 0) printf("Error: a job needs 9 positional arguments, got %d\n", positional);
+        return false;
+    }
+    for (int i = 0; i < serviceOptionCount && argc < JOB_ARGS; i++) argv[argc++] = serviceOptions[i];
+    for (int i = 0; i < optionCount && argc < JOB_ARGS; i++) argv[argc++] = options[i];
+
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) return false;
+
+    MPI_Datatype elementType;
+    if (!datasetElementType(&args, comm, &elementType)) return false;
+    int elementSize;
+    MPI_Type_size(elementType, &elementSize);
+
+    // Start timing
+    double time1 = MPI_Wtime();
+
+    const CachedType* type = lookupType(cache, &args, rank, elementSize, elementType);
+    const SubDomain* subdomain = &type->subdomain;
+    const long localDataSize = (long)subdomain->tempWidth * subdomain->tempHeight *
+                               subdomain->tempDepth * args.timeSteps;
+    int ok = reserveBuffers(cache, (size_t)localDataSize * elementSize, args.timeSteps, rank);
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_MIN, comm);
+    if (!ok) return false;
+
+    MPI_Info info = cachedHints(cache, &args, comm);
+    MPI_File fh;
+    int ret = MPI_File_open(comm, args.inputFile, MPI_MODE_RDONLY, info, &fh);
+    if (ret != MPI_SUCCESS) {
+        if (rank == 0) printf("Error opening file: %s\n", args.inputFile);
+        return false;
+    }
+    MPI_File_set_view(fh, 0, elementType, type->fileType, "native", info);
+    MPI_Status status;
+    MPI_File_read_all(fh, cache->buffer, (int)localDataSize, elementType, &status);
+    MPI_File_close(&fh);
+
+    // End of read timing
+    double time2 = MPI_Wtime();
+
+    // The previous job's reduction has had this job's read to complete in
+    finishPending(cache, comm);
+
+    analyzeLocalDataAs(elementType, cache->buffer, subdomain, cache->localResults, &args);
+
+    // Each job's statistics go out with the job, next to its output file
+    statsReport(&args, comm);
+
+    if (args.reduceOverlap) {
+        PendingJob* pending = &cache->pending;
+        pending->globalResults = rank == 0 ? allocateResults(args.timeSteps) : NULL;
+        reduceResultsStart(cache->localResults, pending->globalResults, args.timeSteps, comm, &pending->reduction);
+
+        // Timing stops once the reduction is posted
+        double time3 = MPI_Wtime();
+        pending->timing.readTime = time2 - time1;
+        pending->timing.mainCodeTime = time3 - time2;
+        pending->timing.totalTime = time3 - time1;
+        MPI_Ireduce(&pending->timing, &pending->maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, comm,
+                    &pending->timingRequest);
+
+        snprintf(pending->outputFile, sizeof(pending->outputFile), "%s", args.outputFile);
+        pending->timeSteps = args.timeSteps;
+        pending->active = true;
+        return true;
+    }
+
+    reduceResults(cache->localResults, cache->globalResults, args.timeSteps, comm);
+
+    // End main code timing
+    double time3 = MPI_Wtime();
+
+    TimingInfo timing;
+    timing.readTime = time2 - time1;
+    timing.mainCodeTime = time3 - time2;
+    timing.totalTime = time3 - time1;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, comm);
+
+    if (rank == 0) {
+        writeResults(args.outputFile, cache->globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s (read %g s, total %g s)\n", args.outputFile,
+               maxTiming.readTime, maxTiming.totalTime);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int rank;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    if (argc < 2) {
+        if (rank == 0) {
+            printf("Usage: %s <manifest|-> [options applied to every job]\n", argv[0]);
+            printf("  Each manifest line: <inputFile> <pX> <pY> <pZ> <nX> <nY> <nZ> <timeSteps> <outputFile> [options]\n");
+            printf("  '-' reads the jobs from stdin; \"quit\" or end of input stops the service\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    FILE* queue = NULL;
+    int opened = 1;
+    if (rank == 0) {
+        queue = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+        if (!queue) {
+            printf("Error: Cannot open job manifest %s\n", argv[1]);
+            opened = 0;
+        }
+    }
+    MPI_Bcast(&opened, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!opened) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    ServiceCache cache;
+    memset(&cache, 0, sizeof(cache));
+
+    // Options after the manifest are placed before each job's own options
+    char** serviceOptions = argv + 2;
+    int serviceOptionCount = argc - 2 < JOB_ARGS / 2 ? argc - 2 : JOB_ARGS / 2;
+
+    int jobs = 0, failed = 0;
+    double start = MPI_Wtime();
+    char line[JOB_LINE];
+    for (;;) {
+        // Rank 0 reads the next job; an empty line on every rank means the queue is done
+        if (rank == 0) {
+            for (;;) {
+                if (!fgets(line, sizeof(line), queue)) {
+                    line[0] = '\0';
+                    break;
+                }
+                line[strcspn(line, "#\r\n")] = '\0';
+                if (strspn(line, " \t") == strlen(line)) continue;
+                if (strncmp(line + strspn(line, " \t"), "quit", 4) == 0) line[0] = '\0';
+                break;
+            }
+        }
+        MPI_Bcast(line, JOB_LINE, MPI_CHAR, 0, MPI_COMM_WORLD);
+        if (line[0] == '\0') break;
+
+        jobs++;
+        if (!runJob(line, argv[0], serviceOptionCount, serviceOptions, &cache, MPI_COMM_WORLD)) {
+            failed++;
+            if (rank == 0) printf("Job %d failed\n", jobs);
+        }
+    }
+
+    finishPending(&cache, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        printf("Service: %d jobs (%d failed) in %g s, file types %d cached / %d created\n",
+               jobs, failed, MPI_Wtime() - start, cache.hits, cache.misses);
+        if (queue != stdin) fclose(queue);
+    }
+
+    // Clean up
+    for (int i = 0; i < cache.count; i++) MPI_Type_free(&cache.types[i].fileType);
+    if (cache.haveInfo) MPI_Info_free(&cache.info);
+    free(cache.buffer);
+    freeResults(cache.localResults);
+    freeResults(cache.globalResults);
+
+    MPI_Finalize();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "stream.h"
+#include "profile.h"
+#include "stats.h"
+
+// Streaming mode: the padded block is read a bounded window of timesteps at a time,
+// so peak memory is two windows regardless of the number of timesteps
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Parse command line arguments
+    ProgramArgs args;
+    if (!parseArguments(argc, argv, rank, size, &args)) {
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Start timing
+    double time1 = MPI_Wtime();
+
+    // Calculate domain decomposition
+    SubDomain subdomain;
+    calculateSubDomainBoundaries(rank, args.pX, args.pY, args.pZ, args.nX, args.nY, args.nZ, &subdomain);
+
+    int window = streamWindowSize(&subdomain, &args, MPI_COMM_WORLD);
+    if (rank == 0) {
+        printf("Streaming %d timesteps in windows of %d\n", args.timeSteps, window);
+    }
+
+    TimeWindowReader reader;
+    if (!streamOpen(&reader, args.inputFile, &subdomain, &args, window, 0, MPI_COMM_WORLD)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        return 1;
+    }
+
+    // Allocate structures for results
+    TimeSeriesResults* localResults = allocateResults(args.timeSteps);
+    TimeSeriesResults* globalResults = NULL;
+
+    // Window k is analysed while window k+1 is being read
+    double analysisTime = 0.0;
+    int start, count;
+    float* windowData;
+    while ((windowData = streamNext(&reader, &start, &count)) != NULL) {
+        double analysisStart = MPI_Wtime();
+
+        ProgramArgs windowArgs = args;
+        windowArgs.timeSteps = count;
+        windowArgs.stepOffset = start;
+        TimeSeriesResults windowResults = resultsWindow(localResults, start);
+        analyzeLocalData(windowData, &subdomain, &windowResults, &windowArgs);
+
+        analysisTime += MPI_Wtime() - analysisStart;
+    }
+
+    double readWait = MPI_Wtime() - time1 - analysisTime;
+    streamClose(&reader);
+
+    // Allocate global results on root process
+    if (rank == 0) {
+        globalResults = allocateResults(args.timeSteps);
+    }
+
+    // Reduce results
+    reduceResults(localResults, globalResults, args.timeSteps, MPI_COMM_WORLD);
+
+    // End main code timing
+    double time3 = MPI_Wtime();
+
+    // Compute timing information: reads overlap the analysis, so the read time is
+    // only the part of the run spent waiting for data
+    TimingInfo timing;
+    timing.readTime = readWait;
+    timing.mainCodeTime = time3 - time1 - readWait;
+    timing.totalTime = time3 - time1;
+
+    TimingInfo maxTiming;
+    MPI_Reduce(&timing, &maxTiming, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    // Write results to file
+    if (rank == 0) {
+        writeResults(args.outputFile, globalResults, args.timeSteps, &maxTiming);
+        printf("Output written to %s\n", args.outputFile);
+        freeResults(globalResults);
+    }
+
+    // Clean up
+    freeResults(localResults);
+
+    // Per-phase breakdown next to the output file
+    statsReport(&args, MPI_COMM_WORLD);
+    profileReport(args.outputFile, MPI_COMM_WORLD);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "dataset.h"
+
+// Parallel synthetic dataset generator: the patterns of scripts/generate_data.py, written
+// as raw [z][y][x][t] plus the .meta side-car. Every value is a function of (seed, x, y, z, t)
+// alone (counter-based hashing, no generator state), so the file does not depend on the
+// number of ranks. Each rank owns a slab of z-planes and writes it with MPI_File_write_at_all
+// a bounded chunk at a time.
+
+#define CHUNK_BYTES (64L * 1024 * 1024)
+#define TWO_PI 6.283185307179586  // M_PI is not in strict C99
+
+typedef enum {
+    PATTERN_WAVE,    // travelling sine/cosine waves plus white noise
+    PATTERN_RANDOM,  // spatially coherent noise drifting over time
+    PATTERN_BLEND    // wave and random mixed with a seeded ratio
+} Pattern;
+
+// Independent streams of the hash
+enum { STREAM_NOISE, STREAM_BASE, STREAM_DRIFT, STREAM_BLEND, STREAMS };
+
+// Smooth noise: uniform values of unit variance on a lattice of the given spacing,
+// interpolated with smoothstep weights. Stands in for gaussian_filter over white noise and
+// needs no neighbouring data, so slabs are generated independently. The two lattice planes
+// around the current z are cached; each lattice point holds one value per step.
+typedef struct {
+    int stream, spacing, steps;
+    long width, height;      // lattice points along x and y
+    long plane;              // lattice z index cached in values, -1 = none
+    double* values;          // [2][height][width][steps]
+    double* weightX;         // smoothstep fraction of every x within its lattice cell
+    double* weightY;
+} Lattice;
+
+typedef struct {
+    Pattern pattern;
+    int nX, nY, nZ, timeSteps;
+    uint64_t keys[STREAMS];  // per-stream hash keys derived from the seed
+    double blendRatio;
+    double noiseLevel;       // white noise of the wave part
+    double baseSmoothness;   // smoothing of the random part (gaussian_filter sigma in Python)
+
+    // Wave terms are separable: sin(a + b) = sin a cos b + cos a sin b over per-axis tables
+    double *sinX, *cosX, *sinY, *cosY, *sinDiag, *cosDiag;
+    double *sinT1, *cosT1, *sinT2, *cosT2, *sinT3, *sinT4, *cosT4;
+    double *driftScale, *driftOffset;
+
+    Lattice base, drift;
+} Generator;
+
+static uint64_t mix(uint64_t h) {
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+}
+
+// Counter-based hash: the value of one counter in one stream, independent of any state
+static uint64_t counterHash(const Generator* g, int stream, uint64_t counter) {
+    return mix(mix(counter + g->keys[stream]));
+}
+
+static double counterUniform(const Generator* g, int stream, uint64_t counter) {
+    return (double)(counterHash(g, stream, counter) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static bool initLattice(Lattice* l, const Generator* g, int stream, int spacing, int steps) {
+    l->stream = stream;
+    l->spacing = spacing;
+    l->steps = steps;
+    l->width = g->nX / spacing + 2;
+    l->height = g->nY / spacing + 2;
+    l->plane = -1;
+    l->values = (double*)malloc(2 * l->width * l->height * steps * sizeof(double));
+    l->weightX = (double*)malloc(g->nX * sizeof(double));
+    l->weightY = (double*)malloc(g->nY * sizeof(double));
+    if (!l->values || !l->weightX || !l->weightY) return false;
+
+    for (int x = 0; x < g->nX; x++) {
+        double f = (double)(x % spacing) / spacing;
+        l->weightX[x] = f * f * (3 - 2 * f);
+    }
+    for (int y = 0; y < g->nY; y++) {
+        double f = (double)(y % spacing) / spacing;
+        l->weightY[y] = f * f * (3 - 2 * f);
+    }
+    return true;
+}
+
+static void freeLattice(Lattice* l) {
+    free(l->values);
+    free(l->weightX);
+    free(l->weightY);
+}
+
+// Noise of point (x, y) in plane z for every step into out; z must not decrease between calls
+static void sampleLattice(Lattice* l, const Generator* g, int x, int y, int z, double* out) {
+    const long plane = z / l->spacing;
+    const long planeValues = l->width * l->height * l->steps;
+    if (plane != l->plane) {
+        // Uniform on [-sqrt(3), sqrt(3)) has unit variance
+        for (int dz = 0; dz < 2; dz++) {
+            uint64_t counter = (uint64_t)(plane + dz) * planeValues;
+            for (long i = 0; i < planeValues; i++) {
+                l->values[dz * planeValues + i] = (2 * counterUniform(g, l->stream, counter + i) - 1) * 1.7320508075688772;
+            }
+        }
+        l->plane = plane;
+    }
+
+    const double fx = l->weightX[x], fy = l->weightY[y];
+    const double fz = (double)(z % l->spacing) / l->spacing;
+    const double wz = fz * fz * (3 - 2 * fz);
+    const double* p = l->values + ((long)(y / l->spacing) * l->width + x / l->spacing) * l->steps;
+    const long dx = l->steps, dy = l->width * l->steps, dz = planeValues;
+
+    for (int t = 0; t < l->steps; t++, p++) {
+        double front = (1 - fx) * p[0] + fx * p[dx];
+        double back = (1 - fx) * p[dy] + fx * p[dy + dx];
+        double below = (1 - fy) * front + fy * back;
+        front = (1 - fx) * p[dz] + fx * p[dz + dx];
+        back = (1 - fx) * p[dz + dy] + fx * p[dz + dy + dx];
+        double above = (1 - fy) * front + fy * back;
+        out[t] = (1 - wz) * below + wz * above;
+    }
+}
+
+static double* table(int n) {
+    return (double*)malloc((n > 0 ? n : 1) * sizeof(double));
+}
+
+// Seed-derived keys, the blend ratio and the lookup tables; false if out of memory
+static bool initGenerator(Generator* g, uint64_t seed) {
+    for (int s = 0; s < STREAMS; s++) {
+        g->keys[s] = mix(seed + 0x9E3779B97F4A7C15ull * (uint64_t)(s + 1));
+    }
+    g->blendRatio = 0.3 + 0.4 * counterUniform(g, STREAM_BLEND, 0);
+    g->noiseLevel = g->pattern == PATTERN_BLEND ? 0.1 : 0.2;
+    g->baseSmoothness = g->pattern == PATTERN_BLEND ? 1.5 : 2.0;
+
+    const int T = g->timeSteps, diagonal = g->nX + g->nY + g->nZ;
+    g->sinX = table(g->nX); g->cosX = table(g->nX);
+    g->sinY = table(g->nY); g->cosY = table(g->nY);
+    g->sinDiag = table(diagonal); g->cosDiag = table(diagonal);
+    g->sinT1 = table(T); g->cosT1 = table(T);
+    g->sinT2 = table(T); g->cosT2 = table(T);
+    g->sinT3 = table(T);
+    g->sinT4 = table(T); g->cosT4 = table(T);
+    g->driftScale = table(T); g->driftOffset = table(T);
+    if (!g->sinX || !g->cosX || !g->sinY || !g->cosY || !g->sinDiag || !g->cosDiag || !g->sinT1 ||
+        !g->cosT1 || !g->sinT2 || !g->cosT2 || !g->sinT3 || !g->sinT4 || !g->cosT4 ||
+        !g->driftScale || !g->driftOffset) {
+        return false;
+    }
+
+    for (int x = 0; x < g->nX; x++) {
+        g->sinX[x] = sin(x * TWO_PI / g->nX);
+        g->cosX[x] = cos(x * TWO_PI / g->nX);
+    }
+    for (int y = 0; y < g->nY; y++) {
+        g->sinY[y] = sin(y * TWO_PI / g->nY);
+        g->cosY[y] = cos(y * TWO_PI / g->nY);
+    }
+    for (int d = 0; d < diagonal; d++) {
+        g->sinDiag[d] = sin(d * 0.1);
+        g->cosDiag[d] = cos(d * 0.1);
+    }
+    for (int t = 0; t < T; t++) {
+        g->sinT1[t] = sin(t * 0.1);
+        g->cosT1[t] = cos(t * 0.1);
+        g->sinT2[t] = sin(t * 0.15);
+        g->cosT2[t] = cos(t * 0.15);
+        g->sinT4[t] = sin(t * TWO_PI / T);
+        g->cosT4[t] = cos(t * TWO_PI / T);
+        g->driftScale[t] = 2.0 * t / T;
+        g->driftOffset[t] = 3 * sin(t * 0.5);
+    }
+
+    // Lattice spacing follows the smoothing: about two sigma for the base field, one for the drift
+    if (g->pattern != PATTERN_WAVE) {
+        int baseSpacing = (int)lround(2 * g->baseSmoothness);
+        int driftSpacing = g->baseSmoothness > 1 ? (int)lround(g->baseSmoothness) : 1;
+        if (!initLattice(&g->base, g, STREAM_BASE, baseSpacing, 1) ||
+            !initLattice(&g->drift, g, STREAM_DRIFT, driftSpacing, T)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void freeGenerator(Generator* g) {
+    double* tables[] = {g->sinX, g->cosX, g->sinY, g->cosY, g->sinDiag, g->cosDiag, g->sinT1, g->cosT1,
+                        g->sinT2, g->cosT2, g->sinT3, g->sinT4, g->cosT4, g->driftScale, g->driftOffset};
+    for (int i = 0; i < (int)(sizeof(tables) / sizeof(tables[0])); i++) free(tables[i]);
+    if (g->pattern != PATTERN_WAVE) {
+        freeLattice(&g->base);
+        freeLattice(&g->drift);
+    }
+}
+
+// Values of plane z, [y][x][t], into buffer (float or double). series holds scratch for
+// two time series.
+static void generatePlane(Generator* g, int z, void* buffer, bool isDouble, double* series) {
+    const int T = g->timeSteps;
+    double* wave = series;
+    double* random = series + T;
+
+    // z term of the wave for this plane
+    for (int t = 0; t < T; t++) {
+        g->sinT3[t] = sin(z * TWO_PI / g->nZ + t * 0.2);
+    }
+
+    long i = 0;
+    for (int y = 0; y < g->nY; y++) {
+        for (int x = 0; x < g->nX; x++) {
+            const uint64_t point = ((uint64_t)z * g->nY + y) * g->nX + x;
+
+            if (g->pattern != PATTERN_RANDOM) {
+                const double sx = g->sinX[x], cx = g->cosX[x], sy = g->sinY[y], cy = g->cosY[y];
+                const double sd = g->sinDiag[x + y + z], cd = g->cosDiag[x + y + z];
+                for (int t = 0; t < T; t++) {
+                    wave[t] = 10 * (sx * g->cosT1[t] + cx * g->sinT1[t]) +
+                              8 * (cy * g->cosT2[t] - sy * g->sinT2[t]) +
+                              6 * g->sinT3[t] +
+                              4 * (cd * g->cosT4[t] - sd * g->sinT4[t]);
+                }
+                // White noise, two timesteps per hash (both Box-Muller outputs)
+                for (int t = 0; t < T; t += 2) {
+                    uint64_t h = counterHash(g, STREAM_NOISE, point * ((T + 1) / 2) + t / 2);
+                    double u1 = ((h >> 32) + 0.5) * (1.0 / 4294967296.0);
+                    double u2 = (h & 0xFFFFFFFFu) * (1.0 / 4294967296.0);
+                    double r = 5 * g->noiseLevel * sqrt(-2.0 * log(u1));
+                    wave[t] += r * cos(TWO_PI * u2);
+                    if (t + 1 < T) wave[t + 1] += r * sin(TWO_PI * u2);
+                }
+            }
+
+            if (g->pattern != PATTERN_WAVE) {
+                double base;
+                sampleLattice(&g->base, g, x, y, z, &base);
+                sampleLattice(&g->drift, g, x, y, z, random);
+                for (int t = 0; t < T; t++) {
+                    random[t] = 10 * base + g->driftScale[t] * random[t] + g->driftOffset[t];
+                }
+            }
+
+            for (int t = 0; t < T; t++, i++) {
+                double v = g->pattern == PATTERN_WAVE ? wave[t] :
+                           g->pattern == PATTERN_RANDOM ? random[t] :
+                           g->blendRatio * wave[t] + (1 - g->blendRatio) * random[t];
+                if (isDouble) ((double*)buffer)[i] = v;
+                else ((float*)buffer)[i] = (float)v;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int rank, size;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (argc < 6) {
+        if (rank == 0) {
+            printf("Usage: %s <nX> <nY> <nZ> <timeSteps> <out.bin> [--pattern=wave|random|blend] "
+                   "[--dtype=float32|float64] [--seed=N]\n", argv[0]);
+            printf("  --pattern   data pattern, as in scripts/generate_data.py (default: random)\n");
+            printf("  --dtype     element type written to the file and its .meta side-car (default: float32)\n");
+            printf("  --seed      seed of the hashed noise; equal seeds give equal files (default: 1)\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    Generator g;
+    g.nX = atoi(argv[1]);
+    g.nY = atoi(argv[2]);
+    g.nZ = atoi(argv[3]);
+    g.timeSteps = atoi(argv[4]);
+    const char* outputFile = argv[5];
+    g.pattern = PATTERN_RANDOM;
+    uint64_t seed = 1;
+    MPI_Datatype elementType = MPI_FLOAT;
+
+    for (int i = 6; i < argc; i++) {
+        bool ok = true;
+        if (strcmp(argv[i], "--pattern=wave") == 0) {
+            g.pattern = PATTERN_WAVE;
+        } else if (strcmp(argv[i], "--pattern=random") == 0) {
+            g.pattern = PATTERN_RANDOM;
+        } else if (strcmp(argv[i], "--pattern=blend") == 0) {
+            g.pattern = PATTERN_BLEND;
+        } else if (strcmp(argv[i], "--dtype=float32") == 0) {
+            elementType = MPI_FLOAT;
+        } else if (strcmp(argv[i], "--dtype=float64") == 0) {
+            elementType = MPI_DOUBLE;
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            char* end;
+            seed = strtoull(argv[i] + 7, &end, 10);
+            ok = end != argv[i] + 7 && *end == '\0';
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            if (rank == 0) printf("Error: unknown option %s\n", argv[i]);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    if (g.nX <= 0 || g.nY <= 0 || g.nZ <= 0 || g.timeSteps <= 0) {
+        if (rank == 0) printf("Error: All dimensions and timesteps must be positive integers\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    const bool isDouble = elementType == MPI_DOUBLE;
+    const long elementSize = isDouble ? sizeof(double) : sizeof(float);
+    const long planeElements = (long)g.nX * g.nY * g.timeSteps;
+    if (planeElements > INT_MAX) {
+        if (rank == 0) printf("Error: one z-plane holds %ld values, more than one write can take\n", planeElements);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    // Contiguous slab of z-planes per rank; a chunk is as many planes as fit CHUNK_BYTES
+    const int z0 = (int)((long)g.nZ * rank / size);
+    const int z1 = (int)((long)g.nZ * (rank + 1) / size);
+    long planesPerChunk = CHUNK_BYTES / (planeElements * elementSize);
+    if (planesPerChunk < 1) planesPerChunk = 1;
+    if (planesPerChunk * planeElements > INT_MAX) planesPerChunk = INT_MAX / planeElements;
+
+    void* buffer = malloc(planesPerChunk * planeElements * elementSize);
+    double* series = (double*)malloc(2 * g.timeSteps * sizeof(double));
+    if (!buffer || !series || !initGenerator(&g, seed)) {
+        printf("Failed to allocate the generator buffers on rank %d\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    double time1 = MPI_Wtime();
+
+    MPI_File fh;
+    int ret = MPI_File_open(MPI_COMM_WORLD, outputFile, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    if (ret != MPI_SUCCESS) {
+        char error_string[MPI_MAX_ERROR_STRING];
+        int length_of_error_string;
+        MPI_Error_string(ret, error_string, &length_of_error_string);
+        if (rank == 0) printf("Error opening file: %s\n", error_string);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    // Cut an older, larger file down to size
+    MPI_File_set_size(fh, (MPI_Offset)g.nZ * planeElements * elementSize);
+
+    // The collective write needs the same number of calls everywhere; idle ranks write nothing
+    long myChunks = (z1 - z0 + planesPerChunk - 1) / planesPerChunk;
+    long chunks;
+    MPI_Allreduce(&myChunks, &chunks, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+
+    for (long c = 0; c < chunks; c++) {
+        int first = z0 + (int)(c * planesPerChunk);
+        int planes = first < z1 ? (int)(z1 - first < planesPerChunk ? z1 - first : planesPerChunk) : 0;
+        for (int p = 0; p < planes; p++) {
+            generatePlane(&g, first + p, (char*)buffer + p * planeElements * elementSize, isDouble, series);
+        }
+
+        MPI_Offset offset = (MPI_Offset)(planes > 0 ? first : 0) * planeElements * elementSize;
+        ret = MPI_File_write_at_all(fh, offset, buffer, (int)(planes * planeElements), elementType,
+                                    MPI_STATUS_IGNORE);
+        if (ret != MPI_SUCCESS) {
+            printf("Error: writing planes %d-%d failed on rank %d\n", first, first + planes - 1, rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_File_close(&fh);
+
+    double elapsed = MPI_Wtime() - time1;
+    free(buffer);
+    free(series);
+    freeGenerator(&g);
+
+    if (rank == 0) {
+        if (!writeDatasetMeta(outputFile, g.nX, g.nY, g.nZ, g.timeSteps, elementType)) {
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        const double bytes = (double)g.nZ * planeElements * elementSize;
+        static const char* names[] = {"wave", "random", "blend"};
+        printf("Wrote %s: %d x %d x %d x %d %s, pattern %s, seed %llu\n", outputFile, g.nX, g.nY, g.nZ,
+               g.timeSteps, isDouble ? "float64" : "float32", names[g.pattern], (unsigned long long)seed);
+        printf("%.2f MB in %.2f s on %d ranks (%.2f GB/s)\n", bytes / (1024 * 1024), elapsed, size,
+               bytes / elapsed / 1e9);
+    }
+
+    MPI_Finalize();
+    return 0;
+}
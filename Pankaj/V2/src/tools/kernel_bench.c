@@ -0,0 +1,417 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "device.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Compute-kernel microbenchmark: every extrema kernel on synthetic in-memory blocks, no I/O
+// and no communication. The block is the padded block of the centre rank of a 3 x 3 x 3
+// grid, so it has ghost layers on every side like an interior rank of a real run.
+// Serial: run it directly (MPI is only initialised for the library's timers).
+
+#define MAX_LIST 16
+
+// Kernels over a prepared block: point-major, or time-major for the variants that say so
+typedef void (*KernelFloat)(float* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+typedef void (*KernelDouble)(double* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps);
+
+// Threaded variant: analyzeLocalData on the fused kernel with benchThreads threads
+static int benchThreads = 0;
+
+static void analyzeThreadedFloat(float* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    ProgramArgs args;
+    memset(&args, 0, sizeof(args));
+    args.timeSteps = timeSteps;
+    args.kernel = KERNEL_FUSED;
+    args.threads = benchThreads;
+    analyzeLocalData(data, subdomain, results, &args);
+}
+
+static void analyzeThreadedDouble(double* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    ProgramArgs args;
+    memset(&args, 0, sizeof(args));
+    args.timeSteps = timeSteps;
+    args.kernel = KERNEL_FUSED;
+    args.threads = benchThreads;
+    analyzeLocalDataDouble(data, subdomain, results, &args);
+}
+
+// Device variants: the owned box through deviceAnalyzeBox, block copy included
+static void analyzeOnDevice(const void* data, bool isDouble, const SubDomain* subdomain, TimeSeriesResults* results,
+                            int timeSteps, DeviceKind device) {
+    LocalBox owned = ownedBox(subdomain);
+    if (!deviceAnalyzeBox(data, isDouble, subdomain, &owned, results, timeSteps, device)) {
+        printf("Error: the %s sweep failed\n", deviceName(device));
+    }
+}
+
+static void gpuFloat(float* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    analyzeOnDevice(data, false, subdomain, results, timeSteps, DEVICE_GPU);
+}
+
+static void gpuDouble(double* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    analyzeOnDevice(data, true, subdomain, results, timeSteps, DEVICE_GPU);
+}
+
+static void offloadFloat(float* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    analyzeOnDevice(data, false, subdomain, results, timeSteps, DEVICE_OFFLOAD);
+}
+
+static void offloadDouble(double* data, const SubDomain* subdomain, TimeSeriesResults* results, int timeSteps) {
+    analyzeOnDevice(data, true, subdomain, results, timeSteps, DEVICE_OFFLOAD);
+}
+
+typedef struct {
+    const char* name;
+    bool timeMajor;         // runs on the transposed copy
+    KernelFloat runFloat;
+    KernelDouble runDouble; // NULL: float only
+} Variant;
+
+// The first entry is the baseline every other variant is checked against
+static const Variant variants[] = {
+    {"scalar", false, processLocalData, processLocalDataDouble},
+    {"fused", false, processLocalDataFused, processLocalDataFusedDouble},
+    {"timemajor", true, processLocalDataTimeMajor, processLocalDataTimeMajorDouble},
+    {"early", false, processLocalDataEarly, processLocalDataEarlyDouble},
+    {"simd", true, processLocalDataSimd, NULL},
+    {"gpu", false, gpuFloat, gpuDouble},
+    {"offload", false, offloadFloat, offloadDouble},
+    {"threaded", false, analyzeThreadedFloat, analyzeThreadedDouble},
+};
+#define VARIANT_COUNT (int)(sizeof(variants) / sizeof(variants[0]))
+
+// CPU cycles of the calling thread, or -1 where perf counters are unavailable
+typedef struct {
+    int fd;
+} CycleCounter;
+
+static void openCycleCounter(CycleCounter* counter) {
+    counter->fd = -1;
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counter->fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void startCycles(const CycleCounter* counter) {
+#ifdef __linux__
+    if (counter->fd < 0) return;
+    ioctl(counter->fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(counter->fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+static long long stopCycles(const CycleCounter* counter) {
+#ifdef __linux__
+    long long cycles;
+    if (counter->fd < 0) return -1;
+    ioctl(counter->fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(counter->fd, &cycles, sizeof(cycles)) == sizeof(cycles)) return cycles;
+#endif
+    return -1;
+}
+
+// --pattern=smooth: a travelling wave instead of hash noise, where few points are extrema
+static bool smoothField = false;
+
+// Deterministic value of global point (x, y, z) at timestep t
+static double syntheticValue(int x, int y, int z, int t) {
+    if (smoothField) {
+        return sin(0.11 * x + 0.3 * t) * cos(0.07 * y) + 0.5 * sin(0.05 * z + 0.2 * t);
+    }
+    uint64_t h = ((((uint64_t)z * 7919u + y) * 7907u + x) * 7901u + t) + 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return (double)(h >> 40) / (double)(1 << 24);
+}
+
+// Fill the padded block [z][y][x][t] from the global coordinates
+static void fillBlock(void* data, int elementSize, const SubDomain* subdomain, int timeSteps) {
+    long i = 0;
+    for (int z = subdomain->tempStartZ; z <= subdomain->tempEndZ; z++) {
+        for (int y = subdomain->tempStartY; y <= subdomain->tempEndY; y++) {
+            for (int x = subdomain->tempStartX; x <= subdomain->tempEndX; x++) {
+                for (int t = 0; t < timeSteps; t++, i++) {
+                    double v = syntheticValue(x, y, z, t);
+                    if (elementSize == sizeof(double)) ((double*)data)[i] = v;
+                    else ((float*)data)[i] = (float)v;
+                }
+            }
+        }
+    }
+}
+
+// Read bandwidth in GB/s (best of a few sums over a buffer well beyond the caches): the memory roof
+static double measureReadBandwidth(void) {
+    const long count = 32L * 1024 * 1024;
+    double* buffer = (double*)malloc(count * sizeof(double));
+    if (!buffer) return 0;
+    for (long i = 0; i < count; i++) buffer[i] = (double)(i & 1023);
+
+    double best = DBL_MAX;
+    volatile double sink = 0;
+    for (int rep = 0; rep < 5; rep++) {
+        double start = MPI_Wtime();
+        double sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        for (long i = 0; i < count; i += 4) {
+            sum0 += buffer[i];
+            sum1 += buffer[i + 1];
+            sum2 += buffer[i + 2];
+            sum3 += buffer[i + 3];
+        }
+        sink += sum0 + sum1 + sum2 + sum3;
+        double elapsed = MPI_Wtime() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    free(buffer);
+    return count * sizeof(double) / best / 1e9;
+}
+
+static bool sameResults(const TimeSeriesResults* a, const TimeSeriesResults* b, int timeSteps) {
+    for (int t = 0; t < timeSteps; t++) {
+        if (a->minimaCount[t] != b->minimaCount[t] || a->maximaCount[t] != b->maximaCount[t] ||
+            a->minValues[t] != b->minValues[t] || a->maxValues[t] != b->maxValues[t]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void resetResults(TimeSeriesResults* results, int timeSteps) {
+    for (int t = 0; t < timeSteps; t++) {
+        results->minimaCount[t] = 0;
+        results->maximaCount[t] = 0;
+        results->minValues[t] = DBL_MAX;
+        results->maxValues[t] = -DBL_MAX;
+    }
+}
+
+// Comma-separated positive integers; returns the count (0 on a malformed list)
+static int parseList(const char* text, int* values) {
+    int count = 0;
+    while (*text && count < MAX_LIST) {
+        char* end;
+        long v = strtol(text, &end, 10);
+        if (end == text || v <= 0) return 0;
+        values[count++] = (int)v;
+        text = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return 0;
+    }
+    return count;
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    int sizes[MAX_LIST] = {32, 64, 96};
+    int steps[MAX_LIST] = {4, 32};
+    int sizeCount = 3, stepCount = 2;
+    int reps = 5;
+    bool useDouble = false;
+    bool selected[VARIANT_COUNT];
+    const char* csvFile = NULL;
+    for (int v = 0; v < VARIANT_COUNT; v++) selected[v] = true;
+
+    for (int i = 1; i < argc; i++) {
+        bool ok = true;
+        if (strncmp(argv[i], "--sizes=", 8) == 0) {
+            ok = (sizeCount = parseList(argv[i] + 8, sizes)) > 0;
+        } else if (strncmp(argv[i], "--steps=", 8) == 0) {
+            ok = (stepCount = parseList(argv[i] + 8, steps)) > 0;
+        } else if (strncmp(argv[i], "--reps=", 7) == 0) {
+            ok = (reps = atoi(argv[i] + 7)) > 0;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            ok = (benchThreads = atoi(argv[i] + 10)) > 0;
+        } else if (strcmp(argv[i], "--type=float") == 0 || strcmp(argv[i], "--type=double") == 0) {
+            useDouble = strcmp(argv[i], "--type=double") == 0;
+        } else if (strcmp(argv[i], "--pattern=noise") == 0 || strcmp(argv[i], "--pattern=smooth") == 0) {
+            smoothField = strcmp(argv[i], "--pattern=smooth") == 0;
+        } else if (strncmp(argv[i], "--variants=", 11) == 0) {
+            // The baseline always runs: it is the reference for the checks
+            for (int v = 1; v < VARIANT_COUNT; v++) selected[v] = false;
+            char list[256];
+            snprintf(list, sizeof(list), "%s", argv[i] + 11);
+            for (char* name = strtok(list, ","); name && ok; name = strtok(NULL, ",")) {
+                int v = 0;
+                while (v < VARIANT_COUNT && strcmp(name, variants[v].name) != 0) v++;
+                if (v < VARIANT_COUNT) selected[v] = true;
+                else ok = false;
+            }
+        } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+            csvFile = argv[i] + 6;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printf("Usage: %s [--sizes=N,...] [--steps=T,...] [--reps=R] [--type=float|double]\n", argv[0]);
+            printf("          [--variants=scalar,fused,timemajor,early,simd,gpu,offload,threaded] [--threads=N]\n");
+            printf("          [--pattern=noise|smooth] [--csv=FILE]\n");
+            printf("  --sizes    owned block edge in points (default 32,64,96)\n");
+            printf("  --steps    timesteps per point (default 4,32)\n");
+            printf("  --reps     timed repetitions per kernel, the best is reported (default 5)\n");
+            printf("  --pattern  hash noise (default) or a smooth wave with few extrema\n");
+            printf("  --csv      append one row per measurement to FILE\n");
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    const int elementSize = useDouble ? sizeof(double) : sizeof(float);
+#ifdef _OPENMP
+    if (benchThreads == 0) benchThreads = omp_get_max_threads();
+#else
+    // Without OpenMP analyzeLocalData runs single-threaded, which the fused row already covers
+    selected[VARIANT_COUNT - 1] = false;
+#endif
+
+    // Device variants only where deviceInit finds the device
+    for (int v = 0; v < VARIANT_COUNT; v++) {
+        DeviceKind device = strcmp(variants[v].name, "gpu") == 0       ? DEVICE_GPU
+                            : strcmp(variants[v].name, "offload") == 0 ? DEVICE_OFFLOAD
+                                                                       : DEVICE_CPU;
+        const char* note = NULL;
+        if (!selected[v] || device == DEVICE_CPU) continue;
+        if (!deviceInit(device, 0, &note)) selected[v] = false;
+        if (note) printf("Device %s: %s\n", deviceName(device), note);
+    }
+
+    CycleCounter counter;
+    openCycleCounter(&counter);
+    const double roof = measureReadBandwidth();
+    printf("Element type: %s, pattern: %s, read bandwidth (roof): %.2f GB/s, cycle counter: %s, threads: %d\n",
+           useDouble ? "float64" : "float32", smoothField ? "smooth" : "noise", roof, counter.fd >= 0 ? "perf_event" : "unavailable",
+           benchThreads > 0 ? benchThreads : 1);
+    printf("%6s %5s %-10s %10s %10s %8s %7s %12s %6s\n",
+           "edge", "steps", "variant", "best_ms", "ns/voxel", "GB/s", "%roof", "cycles/voxel", "check");
+
+    FILE* csv = NULL;
+    if (csvFile) {
+        csv = fopen(csvFile, "a");
+        if (!csv) {
+            printf("Error: Cannot open %s\n", csvFile);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (ftell(csv) == 0) {
+            fprintf(csv, "type,edge,steps,variant,best_seconds,ns_per_voxel,gbps,roof_fraction,cycles_per_voxel,check\n");
+        }
+    }
+
+    int failures = 0;
+    for (int s = 0; s < sizeCount; s++) {
+        for (int k = 0; k < stepCount; k++) {
+            const int edge = sizes[s];
+            const int timeSteps = steps[k];
+
+            SubDomain subdomain;
+            calculateSubDomainBoundaries(13, 3, 3, 3, 3 * edge, 3 * edge, 3 * edge, &subdomain);
+            const long paddedValues = (long)subdomain.tempWidth * subdomain.tempHeight * subdomain.tempDepth * timeSteps;
+            const double voxels = (double)subdomain.width * subdomain.height * subdomain.depth * timeSteps;
+            const double blockBytes = (double)paddedValues * elementSize;
+
+            void* data = malloc(paddedValues * elementSize);
+            TimeSeriesResults* baseline = allocateResults(timeSteps);
+            TimeSeriesResults* results = allocateResults(timeSteps);
+            if (!data || !baseline || !results) {
+                printf("Failed to allocate a %d^3 x %d block\n", edge, timeSteps);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            fillBlock(data, elementSize, &subdomain, timeSteps);
+
+            // The time-major copy is made once; its cost is reported as its own row
+            void* transposed = NULL;
+            double transposeSeconds = 0;
+            for (int v = 0; v < VARIANT_COUNT; v++) {
+                if (!selected[v] || !variants[v].timeMajor || transposed) continue;
+                double start = MPI_Wtime();
+                transposed = useDouble ? (void*)transposeToTimeMajorDouble(data, &subdomain, timeSteps)
+                                       : (void*)transposeToTimeMajor(data, &subdomain, timeSteps);
+                transposeSeconds = MPI_Wtime() - start;
+                if (!transposed) MPI_Abort(MPI_COMM_WORLD, 1);
+                printf("%6d %5d %-10s %10.3f %10.3f %8.2f %7s %12s %6s\n", edge, timeSteps, "transpose",
+                       transposeSeconds * 1e3, transposeSeconds * 1e9 / voxels, 2 * blockBytes / transposeSeconds / 1e9,
+                       "", "", "");
+            }
+
+            for (int v = 0; v < VARIANT_COUNT; v++) {
+                if (!selected[v] || (useDouble && !variants[v].runDouble)) continue;
+                void* input = variants[v].timeMajor ? transposed : data;
+
+                double best = DBL_MAX;
+                long long bestCycles = -1;
+                bool matches = true;
+                for (int rep = 0; rep < reps; rep++) {
+                    resetResults(results, timeSteps);
+                    startCycles(&counter);
+                    double start = MPI_Wtime();
+                    if (useDouble) variants[v].runDouble((double*)input, &subdomain, results, timeSteps);
+                    else variants[v].runFloat((float*)input, &subdomain, results, timeSteps);
+                    double elapsed = MPI_Wtime() - start;
+                    long long cycles = stopCycles(&counter);
+
+                    if (v == 0 && rep == 0) {
+                        mergeResults(baseline, results, timeSteps);
+                    } else {
+                        matches = matches && sameResults(results, baseline, timeSteps);
+                    }
+                    if (elapsed < best) {
+                        best = elapsed;
+                        bestCycles = cycles;
+                    }
+                }
+                if (!matches) failures++;
+
+                // Compulsory traffic: every value of the padded block is read once
+                const double gbps = blockBytes / best / 1e9;
+                char cyclesText[32] = "n/a";
+                if (bestCycles >= 0) snprintf(cyclesText, sizeof(cyclesText), "%.2f", bestCycles / voxels);
+                printf("%6d %5d %-10s %10.3f %10.3f %8.2f %6.1f%% %12s %6s\n", edge, timeSteps, variants[v].name,
+                       best * 1e3, best * 1e9 / voxels, gbps, roof > 0 ? 100 * gbps / roof : 0, cyclesText,
+                       matches ? "ok" : "FAIL");
+                if (csv) {
+                    fprintf(csv, "%s,%d,%d,%s,%.9f,%.4f,%.4f,%.4f,%s,%s\n", useDouble ? "float64" : "float32",
+                            edge, timeSteps, variants[v].name, best, best * 1e9 / voxels, gbps,
+                            roof > 0 ? gbps / roof : 0, bestCycles >= 0 ? cyclesText : "", matches ? "ok" : "FAIL");
+                }
+            }
+
+            free(transposed);
+            free(data);
+            freeResults(baseline);
+            freeResults(results);
+        }
+    }
+
+    if (csv) fclose(csv);
+#ifdef __linux__
+    if (counter.fd >= 0) close(counter.fd);
+#endif
+    if (failures) printf("Error: %d kernel runs disagree with the scalar baseline\n", failures);
+
+    MPI_Finalize();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mpi.h"
+#include "timeseries.h"
+#include "dataset.h"
+#include "chunked.h"
+
+// Converts a raw [z][y][x][t] dataset into the chunked format of chunked.h.
+// Serial: run it as a single process.
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    if (argc < 7) {
+        printf("Usage: %s <raw.bin> <nX> <nY> <nZ> <timeSteps> <out.tsc> [--brick=X,Y,Z] [--align=BYTES]"
+               " [--compress=zlib|none]\n", argv[0]);
+        printf("  --brick=X,Y,Z   brick edge in points (default: a cube of about one alignment unit, or 1 MiB)\n");
+        printf("  --align=BYTES   brick and data alignment, e.g. the file system stripe (default: 0 = packed)\n");
+        printf("  --compress=C    byte-shuffle and deflate each brick (zlib) or store it raw (none, default)\n");
+        MPI_Finalize();
+        return 1;
+    }
+
+    ProgramArgs args;
+    memset(&args, 0, sizeof(args));
+    snprintf(args.inputFile, sizeof(args.inputFile), "%s", argv[1]);
+    args.nX = atoi(argv[2]);
+    args.nY = atoi(argv[3]);
+    args.nZ = atoi(argv[4]);
+    args.timeSteps = atoi(argv[5]);
+    const char* outputFile = argv[6];
+
+    int brick[3] = {0, 0, 0};
+    long alignment = 0;
+    int codec = CHUNKED_CODEC_NONE;
+    for (int i = 7; i < argc; i++) {
+        if (strncmp(argv[i], "--brick=", 8) == 0) {
+            if (sscanf(argv[i] + 8, "%d,%d,%d", &brick[0], &brick[1], &brick[2]) != 3) brick[0] = -1;
+        } else if (strncmp(argv[i], "--align=", 8) == 0) {
+            alignment = atol(argv[i] + 8);
+        } else if (strncmp(argv[i], "--compress=", 11) == 0) {
+            if (strcmp(argv[i] + 11, "zlib") == 0) {
+                codec = CHUNKED_CODEC_SHUFFLE_ZLIB;
+            } else if (strcmp(argv[i] + 11, "none") == 0) {
+                codec = CHUNKED_CODEC_NONE;
+            } else {
+                printf("Error: unknown codec %s (zlib or none)\n", argv[i] + 11);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        } else {
+            printf("Error: unknown option %s\n", argv[i]);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    MPI_Datatype elementType;
+    if (!datasetElementType(&args, MPI_COMM_WORLD, &elementType)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    const int elementSize = elementType == MPI_DOUBLE ? sizeof(double) : sizeof(float);
+
+    // Default brick: a cube whose series fill about one alignment unit (1 MiB when packed)
+    if (brick[0] == 0) {
+        long points = (alignment > 0 ? alignment : 1048576) / ((long)args.timeSteps * elementSize);
+        int edge = (int)cbrt((double)(points > 0 ? points : 1));
+        if (edge < 1) edge = 1;
+        // Even the edge out over each axis so the last brick is not mostly padding
+        const int dims[3] = {args.nX, args.nY, args.nZ};
+        for (int d = 0; d < 3; d++) {
+            int count = (dims[d] + edge - 1) / edge;
+            brick[d] = (dims[d] + count - 1) / count;
+        }
+    }
+    if (brick[0] <= 0 || brick[1] <= 0 || brick[2] <= 0 || alignment < 0) {
+        printf("Error: bricks need three positive edges and the alignment must be >= 0\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (!chunkedCodecSupported(codec)) {
+        printf("Error: built without %s support (make COMPRESSION=zlib)\n", chunkedCodecName(codec));
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    const long values = (long)args.nX * args.nY * args.nZ * args.timeSteps;
+    void* data = malloc(values * elementSize);
+    FILE* fp = fopen(args.inputFile, "rb");
+    if (!data || !fp || fread(data, elementSize, values, fp) != (size_t)values) {
+        printf("Error: cannot read %ld values from %s\n", values, args.inputFile);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    fclose(fp);
+
+    if (!writeChunkedFile(outputFile, data, elementSize, args.nX, args.nY, args.nZ, args.timeSteps, brick, alignment,
+                          codec)) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    printf("Wrote %s: %d x %d x %d bricks, alignment %ld, codec %s\n", outputFile, brick[0], brick[1], brick[2],
+           alignment, chunkedCodecName(codec));
+
+    // Compression ratio against the raw input
+    fp = fopen(outputFile, "rb");
+    if (fp && fseek(fp, 0, SEEK_END) == 0) {
+        long fileBytes = ftell(fp);
+        printf("File size %.2f MB, %.2fx the raw %.2f MB\n", fileBytes / (1024.0 * 1024.0),
+               (double)fileBytes / (values * elementSize), values * elementSize / (1024.0 * 1024.0));
+    }
+    if (fp) fclose(fp);
+
+    free(data);
+    MPI_Finalize();
+    return 0;
+}